@@ -1,4 +1,6 @@
 function(create_config_header targetName)
+    set(SFDM_WITH_ZXING_DECODER ${sfdm_WITH_ZXING_DECODER})
+    set(SFDM_WITH_LIBDMTX_DECODER ${sfdm_WITH_LIBDMTX_DECODER})
     configure_file(
             cmake/sfdm_config.hpp.in
             ${CMAKE_CURRENT_BINARY_DIR}/include/sfdm/sfdm_config.hpp
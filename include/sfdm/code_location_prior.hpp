@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <sfdm/decode_result.hpp>
+#include <sfdm/image_view.hpp>
+#include <span>
+#include <vector>
+
+namespace sfdm {
+    /*!
+     * Learned prior of where codes appear in the frames of a line. The centers of decoded codes are accumulated into a
+     * low resolution heatmap, that decays with every observed frame, so zones that are no longer used cool down.
+     * Positions are stored relative to the image size, so frames of different resolutions share a prior. All methods
+     * are thread safe, one prior can be shared by the readers of a line.
+     */
+    class CodeLocationPrior {
+    public:
+        struct Cell {
+            size_t column{};
+            size_t row{};
+            double heat{};
+        };
+
+        /*!
+         * @param columns cells of the heatmap in horizontal direction
+         * @param rows cells of the heatmap in vertical direction
+         * @param decay factor the heat is multiplied with for every observed frame, in (0, 1]
+         */
+        explicit CodeLocationPrior(size_t columns = 8, size_t rows = 8, double decay = 0.9);
+
+        /*!
+         * Decays the heatmap and adds one to the cell of each code center.
+         * @param image the frame the codes were decoded in
+         * @param positions positions of the codes in the frame, may be empty
+         */
+        void observe(const ImageView &image, std::span<const CodePosition> positions);
+
+        /*!
+         * Cells, whose heat is at least minimumHeat, hottest first. With the default decay, a cell holding a single
+         * code cools below the default threshold after about 22 frames without codes.
+         */
+        [[nodiscard]] std::vector<Cell> getHotCells(double minimumHeat = 0.1) const;
+
+        [[nodiscard]] double getHeat(size_t column, size_t row) const;
+        [[nodiscard]] size_t getColumns() const;
+        [[nodiscard]] size_t getRows() const;
+
+        void reset();
+
+    private:
+        size_t m_columns;
+        size_t m_rows;
+        double m_decay;
+        mutable std::mutex m_mutex;
+        std::vector<double> m_heat;
+    };
+} // namespace sfdm
@@ -0,0 +1,242 @@
+#pragma once
+#include <concepts>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <sfdm/decode_options.hpp>
+#include <sfdm/decode_result.hpp>
+#include <sfdm/image_view.hpp>
+#include <sfdm/sfdm_config.hpp>
+#include <stop_token>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef SFDM_WITH_ZXING_DECODER
+#include <sfdm/zxing_code_reader.hpp>
+#endif
+#ifdef SFDM_WITH_LIBDMTX_DECODER
+#include <sfdm/libdmtx_code_reader.hpp>
+#endif
+
+namespace sfdm {
+    namespace detail {
+        /*!
+         * Whether both positions describe the same code, even if the corners are labeled differently by the backends.
+         */
+        [[nodiscard]] bool isSamePosition(const CodePosition &p1, const CodePosition &p2);
+    } // namespace detail
+
+    /*!
+     * Backends are asked one after another. The next backend is only asked while fewer than the maximum number of
+     * codes were found. Put the cheapest backend first.
+     */
+    struct SequentialStrategy {};
+
+    /*!
+     * Backends run in parallel. The results of the first backend, that finishes with at least one code, are taken,
+     * the results of the others are dropped. The sink receives them as soon as the winner finishes and a stop is
+     * requested on the stop token of the other backends. The call returns once they noticed it.
+     */
+    struct RacingStrategy {};
+
+    /*!
+     * Backends run in parallel. The results of all backends are merged, codes found by several backends are reported
+     * once. A stop is requested on the stop token of the backends, as soon as the maximum number of codes was found.
+     */
+    struct MergingStrategy {};
+
+    /*!
+     * Any type with a non-virtual or final decode(image, options), e.g. the readers of this library.
+     */
+    template<typename Backend>
+    concept CompositeBackend = requires(const Backend &backend, const ImageView &image, const DecodeOptions &options) {
+        { backend.decode(image, options) } -> std::same_as<std::vector<DecodeResult>>;
+    };
+
+    /*!
+     * Reader composed of several backends at compile time. Backends are called directly, not through ICodeReader, and
+     * the sink is a template parameter, so neither needs virtual dispatch nor std::function. Only the code of the
+     * selected strategy is instantiated.
+     * The maximum number of codes of the options applies to the composite. Every backend applies the other options
+     * itself.
+     */
+    template<typename Strategy, CompositeBackend... Backends>
+    class CompositeReader {
+        static_assert(sizeof...(Backends) > 0, "a composite reader needs at least one backend");
+        static_assert(std::is_same_v<Strategy, SequentialStrategy> || std::is_same_v<Strategy, RacingStrategy> ||
+                              std::is_same_v<Strategy, MergingStrategy>,
+                      "unknown composition strategy");
+
+    public:
+        CompositeReader() = default;
+        explicit CompositeReader(Backends &&...backends) : m_backends{std::move(backends)...} {}
+
+        /*!
+         * Decode datamatrix codes and pass every result to the sink.
+         * With the racing and merging strategy, the sink is called from the backend threads, but never concurrently.
+         * An exception thrown by a backend stops the other backends and is rethrown on the calling thread.
+         * @param image image used for datamatrix code detection and decoding
+         * @param options options for this call, passed on to every backend
+         * @param sink called with every DecodeResult
+         * @return Number of results passed to the sink
+         */
+        template<typename Sink>
+            requires std::invocable<Sink &, DecodeResult &&>
+        size_t decode(const ImageView &image, const DecodeOptions &options, Sink &&sink) const {
+            Collector<Sink> collector{sink, options.maximumNumberOfCodesToDetect};
+            if constexpr (sizeof...(Backends) == 1 || std::is_same_v<Strategy, SequentialStrategy>) {
+                decodeSequentially(image, options, collector);
+            } else {
+                decodeInParallel(image, options, collector, std::index_sequence_for<Backends...>{});
+            }
+            return collector.count();
+        }
+
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image, const DecodeOptions &options) const {
+            std::vector<DecodeResult> results;
+            decode(image, options, [&results](DecodeResult &&result) { results.emplace_back(std::move(result)); });
+            return results;
+        }
+
+        /*!
+         * Access to the backends, e.g. to set up their default options. Must not be called while other threads
+         * decode.
+         */
+        template<size_t Index>
+        [[nodiscard]] auto &getBackend() {
+            return std::get<Index>(m_backends);
+        }
+        template<size_t Index>
+        [[nodiscard]] const auto &getBackend() const {
+            return std::get<Index>(m_backends);
+        }
+
+    private:
+        // deduplicates and counts the results. Not thread safe, parallel strategies lock around it.
+        template<typename Sink>
+        class Collector {
+        public:
+            Collector(Sink &sink, size_t maximumCount) : m_sink{sink}, m_maximumCount{maximumCount} {}
+
+            void add(DecodeResult &&result) {
+                if (isFull()) {
+                    return;
+                }
+                for (const auto &position: m_positions) {
+                    if (detail::isSamePosition(position, result.position)) {
+                        return;
+                    }
+                }
+                m_positions.push_back(result.position);
+                std::invoke(m_sink, std::move(result));
+            }
+
+            [[nodiscard]] bool isFull() const { return m_positions.size() >= m_maximumCount; }
+            [[nodiscard]] size_t count() const { return m_positions.size(); }
+
+        private:
+            Sink &m_sink;
+            size_t m_maximumCount;
+            std::vector<CodePosition> m_positions;
+        };
+
+        // the qualified call is dispatched statically, also for backends implementing ICodeReader
+        template<typename Backend>
+        static std::vector<DecodeResult> decodeWith(const Backend &backend, const ImageView &image,
+                                                    const DecodeOptions &options) {
+            return backend.Backend::decode(image, options);
+        }
+
+        template<typename Sink>
+        void decodeSequentially(const ImageView &image, const DecodeOptions &options,
+                                Collector<Sink> &collector) const {
+            std::apply(
+                    [&](const auto &...backends) {
+                        // the fold stops at the first backend, after which the collector is full
+                        (void) (... && [&](const auto &backend) {
+                            for (auto &result: decodeWith(backend, image, options)) {
+                                collector.add(std::move(result));
+                            }
+                            return !collector.isFull();
+                        }(backends));
+                    },
+                    m_backends);
+        }
+
+        template<typename Sink, size_t... Indices>
+        void decodeInParallel(const ImageView &image, const DecodeOptions &options, Collector<Sink> &collector,
+                              std::index_sequence<Indices...>) const {
+            std::mutex collectorMutex;
+            bool decided = false;
+            std::exception_ptr error;
+
+            // a stop requested by the caller stops all backends
+            std::stop_source stopSource;
+            const std::stop_callback forwardStop(options.stopToken, [&] { stopSource.request_stop(); });
+            auto backendOptions = options;
+            backendOptions.stopToken = stopSource.get_token();
+
+            const auto run = [&](const auto &backend) {
+                try {
+                    auto results = decodeWith(backend, image, backendOptions);
+                    std::lock_guard lock(collectorMutex);
+                    if constexpr (std::is_same_v<Strategy, RacingStrategy>) {
+                        if (decided || results.empty()) {
+                            return;
+                        }
+                        decided = true;
+                        stopSource.request_stop();
+                    }
+                    for (auto &result: results) {
+                        collector.add(std::move(result));
+                    }
+                    if (collector.isFull()) {
+                        stopSource.request_stop();
+                    }
+                } catch (...) {
+                    std::lock_guard lock(collectorMutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                    stopSource.request_stop();
+                }
+            };
+
+            {
+                // the first backend runs on the calling thread
+                std::vector<std::jthread> threads;
+                threads.reserve(sizeof...(Backends) - 1);
+                (
+                        [&] {
+                            if constexpr (Indices > 0) {
+                                threads.emplace_back([&] { run(std::get<Indices>(m_backends)); });
+                            }
+                        }(),
+                        ...);
+                run(std::get<0>(m_backends));
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        std::tuple<Backends...> m_backends;
+    };
+
+#if defined(SFDM_WITH_LIBDMTX_DECODER) && defined(SFDM_WITH_ZXING_DECODER)
+    /*!
+     * Both backends in parallel, results merged. Like LibdmtxZXingCombinedCodeReader, but without double checking
+     * ZXing texts and without virtual dispatch.
+     */
+    using MergedLibdmtxZXingReader = CompositeReader<MergingStrategy, LibdmtxCodeReader, ZXingCodeReader>;
+
+    /*!
+     * ZXing first, libdmtx only for frames, in which ZXing found fewer than the maximum number of codes.
+     */
+    using ZXingLibdmtxFallbackReader = CompositeReader<SequentialStrategy, ZXingCodeReader, LibdmtxCodeReader>;
+#endif
+} // namespace sfdm
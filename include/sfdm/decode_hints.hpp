@@ -0,0 +1,57 @@
+#pragma once
+#include <compare>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace sfdm {
+    enum class SymbolShape {
+        Any,
+        Square,
+        Rectangle,
+    };
+
+    /*!
+     * Datamatrix symbol size in modules, including the finder pattern, e.g. 16x16 or 12x36 (rows x columns).
+     */
+    struct SymbolSize {
+        uint32_t rows{};
+        uint32_t columns{};
+        auto operator<=>(const SymbolSize &) const = default;
+    };
+
+    /*!
+     * Prior knowledge about the codes in the images. Tight hints shrink the search space of the readers and make them
+     * reject candidates earlier. Unset values keep the defaults of the backends.
+     */
+    struct DecodeHints {
+        /*!
+         * Expected symbol sizes. Empty means all sizes of the expected shape.
+         */
+        std::vector<SymbolSize> symbolSizes;
+        SymbolShape shape{SymbolShape::Any};
+
+        /*!
+         * Expected size of one module in pixels
+         */
+        std::optional<uint32_t> minModuleSize;
+        std::optional<uint32_t> maxModuleSize;
+
+        /*!
+         * Minimum edge strength (1-100) of the finder pattern. Higher values reject weak edges. libdmtx only.
+         */
+        std::optional<uint32_t> edgeThreshold;
+
+        /*!
+         * Maximum deviation of the finder pattern corner from 90 degrees. libdmtx only.
+         */
+        std::optional<uint32_t> squareDeviation;
+
+        /*!
+         * Distance in pixels between the lines scanned for finder patterns. libdmtx only.
+         */
+        std::optional<uint32_t> scanGap;
+
+        auto operator<=>(const DecodeHints &) const = default;
+    };
+} // namespace sfdm
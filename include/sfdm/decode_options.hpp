@@ -0,0 +1,93 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <sfdm/decode_hints.hpp>
+#include <sfdm/image_quality.hpp>
+#include <sfdm/image_view.hpp>
+#include <stop_token>
+
+namespace sfdm {
+    class CodeLocationPrior;
+    class ExpectedPayloads;
+
+    /*!
+     * Options for a single decode call. Passing them per call keeps the readers free of per frame state, so one reader
+     * can be shared between threads that decode with different options.
+     */
+    struct DecodeOptions {
+        /*!
+         * Detection timeout in milliseconds, that is reset after each detected code. 0 searches until nothing can be
+         * found. Ignored by readers without timeout support.
+         */
+        uint32_t timeoutMSec{200};
+
+        /*!
+         * Point in time after which decoding stops and returns the codes found so far.
+         */
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+
+        size_t maximumNumberOfCodesToDetect{255};
+
+        DecodeHints hints;
+
+        /*!
+         * Payloads expected in the image. If set, only codes matching a not yet found item count towards the maximum
+         * number of codes, and decoding stops as soon as every item was found. Other codes are still returned.
+         */
+        std::shared_ptr<const ExpectedPayloads> expectedPayloads;
+
+        /*!
+         * Quality thresholds checked before the scan starts. Frames, that fail, are rejected or decoded with less
+         * effort. The measured quality is returned by the decode overload taking a DecodeReport.
+         */
+        std::optional<QualityGate> qualityGate;
+
+        /*!
+         * Number of effort levels tried at most, for readers with an effort ladder (ZXing).
+         */
+        std::optional<size_t> maximumEffortLevels;
+
+        /*!
+         * Working memory a decode call may use, in bytes. Readers stay below it by decoding backends one after another,
+         * decoding the image in horizontal strips or decoding a downscaled copy. Detection and the lazy decode of
+         * detections ignore the limit.
+         */
+        std::optional<size_t> memoryLimit;
+
+        /*!
+         * Where codes appeared in earlier frames. libdmtx searches the surroundings of the four hottest cells first,
+         * within one shared timeout, and the whole image afterwards. Then it feeds the codes it found into the prior.
+         * Readers, that decode parts of the image (strips, template slots), do not pass it on. VariantRacingCodeReader
+         * searches the variants without it and feeds the merged codes of all variants into it once.
+         */
+        std::shared_ptr<CodeLocationPrior> locationPrior;
+
+        /*!
+         * Decoding stops and returns the codes found so far, once a stop is requested, e.g. because a concurrent decode
+         * of the same frame already found the codes. libdmtx checks it every few milliseconds while searching for
+         * regions, ZXing only before each effort level.
+         */
+        std::stop_token stopToken;
+
+        [[nodiscard]] bool isDeadlineExpired() const {
+            return deadline && std::chrono::steady_clock::now() >= *deadline;
+        }
+
+        /*!
+         * Whether the deadline expired or a stop was requested.
+         */
+        [[nodiscard]] bool shouldStop() const { return stopToken.stop_requested() || isDeadlineExpired(); }
+    };
+
+    /*!
+     * Measures the image quality and applies the quality gate of the options.
+     * @param image image to measure
+     * @param options options with or without quality gate
+     * @param report receives the measured quality and the action taken
+     * @return Options to decode with, without quality gate. Nothing, if the frame is rejected.
+     */
+    [[nodiscard]] std::optional<DecodeOptions> applyQualityGate(const ImageView &image, const DecodeOptions &options,
+                                                                DecodeReport &report);
+} // namespace sfdm
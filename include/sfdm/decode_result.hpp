@@ -1,10 +1,63 @@
 #pragma once
+#include <array>
 #include <coroutine>
 #include <cstdint>
+#include <new>
 #include <string>
 #include <utility>
 
 namespace sfdm {
+    namespace detail {
+        /*!
+         * Per thread cache of coroutine frames. Frames of the same coroutine always have the same size, so a freed
+         * frame is handed out again for the next call instead of going through the heap.
+         */
+        class CoroutineFramePool {
+        public:
+            static void *allocate(size_t size) {
+                for (auto &block: instance().m_blocks) {
+                    if (block.memory && block.size == size) {
+                        return std::exchange(block.memory, nullptr);
+                    }
+                }
+                return ::operator new(size);
+            }
+
+            static void deallocate(void *memory, size_t size) noexcept {
+                for (auto &block: instance().m_blocks) {
+                    if (!block.memory) {
+                        block = {memory, size};
+                        return;
+                    }
+                }
+                ::operator delete(memory);
+            }
+
+            CoroutineFramePool(const CoroutineFramePool &) = delete;
+            CoroutineFramePool &operator=(const CoroutineFramePool &) = delete;
+
+        private:
+            struct Block {
+                void *memory{};
+                size_t size{};
+            };
+
+            CoroutineFramePool() = default;
+            ~CoroutineFramePool() {
+                for (const auto &block: m_blocks) {
+                    ::operator delete(block.memory);
+                }
+            }
+
+            static CoroutineFramePool &instance() {
+                thread_local CoroutineFramePool pool;
+                return pool;
+            }
+
+            std::array<Block, 4> m_blocks{};
+        };
+    } // namespace detail
+
     struct Point {
         uint32_t x{};
         uint32_t y{};
@@ -46,6 +99,11 @@ namespace sfdm {
         struct promise_type {
             DecodeResult current;
 
+            static void *operator new(size_t size) { return detail::CoroutineFramePool::allocate(size); }
+            static void operator delete(void *memory, size_t size) noexcept {
+                detail::CoroutineFramePool::deallocate(memory, size);
+            }
+
             ResultStream get_return_object() {
                 return ResultStream{std::coroutine_handle<promise_type>::from_promise(*this)};
             }
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <sfdm/decode_result.hpp>
+#include <string_view>
+#include <vector>
+
+namespace sfdm {
+    struct DecodeResultView {
+        std::string_view text;
+        CodePosition position{};
+    };
+
+    /*!
+     * Caller owned, reusable storage for decode results. Texts are stored in one byte arena. Clearing the buffer keeps
+     * its storage, so once the buffer has grown to the size needed for a frame, decoding into it does not allocate.
+     */
+    class DecodeResultBuffer {
+    public:
+        /*!
+         * @param expectedNumberOfResults number of results to reserve storage for
+         * @param expectedTextBytes number of text bytes to reserve storage for
+         */
+        explicit DecodeResultBuffer(size_t expectedNumberOfResults = 16, size_t expectedTextBytes = 4096) {
+            m_entries.reserve(expectedNumberOfResults);
+            m_text.reserve(expectedTextBytes);
+        }
+
+        /*!
+         * Removes all results, but keeps the storage.
+         */
+        void clear() {
+            m_entries.clear();
+            m_text.clear();
+        }
+
+        void push(std::string_view text, const CodePosition &position) {
+            m_entries.push_back({m_text.size(), text.size(), position});
+            m_text.insert(m_text.end(), text.begin(), text.end());
+        }
+
+        [[nodiscard]] size_t size() const { return m_entries.size(); }
+        [[nodiscard]] bool empty() const { return m_entries.empty(); }
+
+        /*!
+         * The text of the view is valid until the buffer is modified.
+         */
+        [[nodiscard]] DecodeResultView operator[](size_t index) const {
+            const auto &entry = m_entries[index];
+            return {{m_text.data() + entry.textOffset, entry.textLength}, entry.position};
+        }
+
+        [[nodiscard]] std::vector<DecodeResult> toDecodeResults() const {
+            std::vector<DecodeResult> results;
+            results.reserve(size());
+            for (size_t i = 0; i < size(); ++i) {
+                const auto view = (*this)[i];
+                results.emplace_back(std::string{view.text}, view.position);
+            }
+            return results;
+        }
+
+    private:
+        // offsets instead of views, so growing the arena does not invalidate earlier results
+        struct Entry {
+            size_t textOffset;
+            size_t textLength;
+            CodePosition position;
+        };
+
+        std::vector<Entry> m_entries;
+        std::vector<char> m_text;
+    };
+} // namespace sfdm
@@ -0,0 +1,27 @@
+#pragma once
+#include <memory>
+#include <sfdm/decode_result.hpp>
+
+namespace sfdm {
+    namespace detail {
+        /*!
+         * Backend specific state of a detection, e.g. the libdmtx region. Lets the lazy decode skip the search.
+         */
+        struct DetectionState {
+            virtual ~DetectionState() = default;
+        };
+    } // namespace detail
+
+    /*!
+     * A code, that was located, but not decoded yet. Pass it to ICodeReader::decode(image, detection) together with
+     * the same image to decode it on demand.
+     */
+    struct DetectionResult {
+        CodePosition position{};
+        /*!
+         * Set by the reader, that detected the code. Detections without state, e.g. positions from an earlier frame,
+         * are searched for again in the surroundings of their position.
+         */
+        std::shared_ptr<const detail::DetectionState> state;
+    };
+} // namespace sfdm
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sfdm {
+    /*!
+     * Payloads expected in an image, e.g. from a manifest. Each item is either an exact text or a regular expression
+     * (ECMAScript) that has to match the whole text. Every item stands for one code, so an item listed twice expects
+     * two codes.
+     */
+    class ExpectedPayloads {
+    public:
+        ExpectedPayloads() = default;
+
+        /*!
+         * @param texts exact payloads
+         */
+        explicit ExpectedPayloads(std::vector<std::string> texts);
+
+        void addText(std::string text);
+
+        /*!
+         * @param pattern regular expression, that has to match the whole payload
+         */
+        void addPattern(const std::string &pattern);
+
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] bool empty() const;
+
+        /*!
+         * Whether the text matches the item at the given index.
+         */
+        [[nodiscard]] bool matches(size_t index, std::string_view text) const;
+
+    private:
+        struct Item {
+            std::string text;
+            std::optional<std::regex> pattern;
+        };
+
+        std::vector<Item> m_items;
+    };
+} // namespace sfdm
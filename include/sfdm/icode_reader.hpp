@@ -1,19 +1,131 @@
 #pragma once
 #include <functional>
+#include <optional>
+#include <sfdm/decode_hints.hpp>
+#include <sfdm/decode_options.hpp>
 #include <sfdm/decode_result.hpp>
+#include <sfdm/decode_result_buffer.hpp>
+#include <sfdm/detection_result.hpp>
+#include <sfdm/image_quality.hpp>
 #include <sfdm/image_view.hpp>
 #include <vector>
 
 namespace sfdm {
+    /*!
+     * Readers do not change their state while decoding. The decode functions taking DecodeOptions can be called from
+     * any number of threads on the same reader. The setters only change the options used by the decode functions
+     * without DecodeOptions and must not be called while other threads decode.
+     */
     class ICodeReader {
     public:
         virtual ~ICodeReader() = default;
 
-        // virtual std::vector<DetectionResult> detect(const cv::Mat& image) = 0;
-        [[nodiscard]] virtual std::vector<DecodeResult> decode(const ImageView &image) const = 0;
         [[nodiscard]] virtual std::vector<DecodeResult> decode(const ImageView &image,
+                                                               const DecodeOptions &options) const = 0;
+        [[nodiscard]] virtual std::vector<DecodeResult> decode(const ImageView &image, const DecodeOptions &options,
                                                                std::function<void(DecodeResult)> callback) const = 0;
 
+        /*!
+         * Decode datamatrix codes in the provided image into caller owned storage. The buffer is cleared first.
+         * Readers that support it decode without heap allocations, once the buffer has reached its steady state size.
+         * The default implementation copies the results of decode(image, options).
+         * @param image image used for datamatrix code detection and decoding
+         * @param options options for this call
+         * @param results buffer receiving the decoded results
+         */
+        virtual void decode(const ImageView &image, const DecodeOptions &options, DecodeResultBuffer &results) const {
+            results.clear();
+            for (const auto &result: decode(image, options)) {
+                results.push(result.text, result.position);
+            }
+        }
+
+        /*!
+         * Decode datamatrix codes and report details about the call, e.g. the image quality measured by the quality
+         * gate of the options.
+         * @param image image used for datamatrix code detection and decoding
+         * @param options options for this call
+         * @param report receives the details, it is reset first
+         * @return Decoded results that were found in the image. Empty, if the quality gate rejected the image.
+         */
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image, const DecodeOptions &options,
+                                                       DecodeReport &report) const {
+            report = {};
+            if (!options.qualityGate) {
+                report.memory = estimateMemoryUsage(image, options);
+                return decode(image, options);
+            }
+            const auto gatedOptions = applyQualityGate(image, options, report);
+            if (!gatedOptions) {
+                return {};
+            }
+            report.memory = estimateMemoryUsage(image, *gatedOptions);
+            return decode(image, *gatedOptions);
+        }
+
+        /*!
+         * Estimates the working memory of decode(image, options) by component. With a memory limit in the options,
+         * the estimate includes the strategies the reader chooses to stay below it. Decoding with a callback can add
+         * callback threads. The default implementation knows nothing about the reader and returns an empty usage.
+         * @param image image to decode
+         * @param options options of the decode call
+         * @return Estimated peak usage
+         */
+        [[nodiscard]] virtual MemoryUsage estimateMemoryUsage(const ImageView &image,
+                                                              const DecodeOptions &options) const {
+            (void) image;
+            (void) options;
+            return {};
+        }
+
+        /*!
+         * Locate datamatrix codes without decoding their payloads. Cheaper than decoding, if only the positions or the
+         * number of codes are needed. The maximum number of codes, the timeout, the deadline, the hints and the quality
+         * gate of the options apply, expected payloads are ignored.
+         * @param image image used for datamatrix code detection
+         * @param options options for this call
+         * @return Detected codes
+         */
+        [[nodiscard]] virtual std::vector<DetectionResult> detect(const ImageView &image,
+                                                                  const DecodeOptions &options) const = 0;
+
+        /*!
+         * Decode one detected code on demand.
+         * @param image the image the code was detected in
+         * @param detection result of detect, or a position of the code
+         * @param options options for this call
+         * @return Decoded result, or nothing if the code could not be decoded
+         */
+        [[nodiscard]] virtual std::optional<DecodeResult> decode(const ImageView &image,
+                                                                 const DetectionResult &detection,
+                                                                 const DecodeOptions &options) const = 0;
+
+        /*!
+         * Decode with the options set by the setters.
+         */
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image) const {
+            return decode(image, getDefaultOptions());
+        }
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image,
+                                                       std::function<void(DecodeResult)> callback) const {
+            return decode(image, getDefaultOptions(), std::move(callback));
+        }
+        void decode(const ImageView &image, DecodeResultBuffer &results) const {
+            decode(image, getDefaultOptions(), results);
+        }
+        [[nodiscard]] std::vector<DetectionResult> detect(const ImageView &image) const {
+            return detect(image, getDefaultOptions());
+        }
+        [[nodiscard]] std::optional<DecodeResult> decode(const ImageView &image,
+                                                         const DetectionResult &detection) const {
+            return decode(image, detection, getDefaultOptions());
+        }
+
+        /*!
+         * Options used by the decode functions without DecodeOptions. They are changed by the setters.
+         */
+        [[nodiscard]] virtual const DecodeOptions &getDefaultOptions() const = 0;
+
         virtual void setTimeout(uint32_t msec) = 0;
         [[nodiscard]] virtual uint32_t getTimeout() const = 0;
         virtual bool isTimeoutSupported() = 0;
@@ -22,5 +134,13 @@ namespace sfdm {
         [[nodiscard]] virtual size_t getMaximumNumberOfCodesToDetect() const = 0;
 
         virtual bool isDecodeWithCallbackSupported() = 0;
+
+        /*!
+         * Sets prior knowledge about the codes, e.g. their symbol sizes and module sizes. Backends apply the hints
+         * they support and ignore the others.
+         * @param hints hints for all following decode calls
+         */
+        virtual void setHints(const DecodeHints &hints) = 0;
+        [[nodiscard]] virtual const DecodeHints &getHints() const = 0;
     };
 } // namespace sfdm
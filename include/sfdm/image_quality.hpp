@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <sfdm/image_view.hpp>
+#include <sfdm/memory_usage.hpp>
+
+namespace sfdm {
+    /*!
+     * Image quality metrics, estimated on a subsampled grid of the image.
+     */
+    struct ImageQuality {
+        /*!
+         * Variance of the Laplacian. Low values indicate motion blur or defocus.
+         */
+        double sharpness{};
+        /*!
+         * Mean gray value (0-255)
+         */
+        double brightness{};
+        /*!
+         * Difference of the 95th and the 5th percentile of the gray values
+         */
+        double contrast{};
+        /*!
+         * Fraction of samples, that are saturated (>= 250)
+         */
+        double overexposedFraction{};
+        /*!
+         * Fraction of samples, that are black (<= 5)
+         */
+        double underexposedFraction{};
+    };
+
+    enum class QualityAction {
+        Decode,
+        /*!
+         * Decode with a short timeout and only the cheapest effort levels
+         */
+        Downgrade,
+        /*!
+         * Skip decoding
+         */
+        Reject,
+    };
+
+    /*!
+     * Thresholds checked before the scan starts. The defaults accept every frame.
+     */
+    struct QualityGate {
+        double minSharpness{};
+        double minContrast{};
+        double maxOverexposedFraction{1.0};
+        double maxUnderexposedFraction{1.0};
+        /*!
+         * Action for frames, that violate a threshold
+         */
+        QualityAction onFailure{QualityAction::Reject};
+        /*!
+         * Distance between two samples in pixels, in both directions
+         */
+        size_t sampleStep{4};
+        uint32_t downgradedTimeoutMSec{20};
+        size_t downgradedEffortLevels{1};
+    };
+
+    /*!
+     * Details about a decode call
+     */
+    struct DecodeReport {
+        /*!
+         * Measured image quality, if the options had a quality gate
+         */
+        std::optional<ImageQuality> quality;
+        QualityAction qualityAction{QualityAction::Decode};
+        /*!
+         * Estimated working memory of the call and the strategies chosen to stay below the memory limit
+         */
+        MemoryUsage memory;
+    };
+
+    /*!
+     * Estimates the quality of the image on a grid with sampleStep pixels between two samples.
+     * The Laplacian uses the direct neighbours of each sample, so blur is detected at full resolution.
+     */
+    [[nodiscard]] ImageQuality measureImageQuality(const ImageView &image, size_t sampleStep = 4);
+
+    [[nodiscard]] QualityAction evaluateQualityGate(const ImageQuality &quality, const QualityGate &gate);
+} // namespace sfdm
@@ -16,16 +16,23 @@ namespace sfdm {
      */
     class LibdmtxCodeReader : public ICodeReader {
     public:
+        using ICodeReader::decode;
+        using ICodeReader::detect;
+
         /*!
          * Decode datamatrix codes in the provided image.
          * This is a blocking call until the decoding of all datamatrix codes in the image are finished.
          * It is recommended to set the number of datamatrix codes that can be detected, because then this function will
          * return faster. How fast the function "gives up" searching for codes in the image, can be tuned with the
-         * setTimeout function.
+         * timeout of the options.
+         * With a location prior in the options, the surroundings of its hottest cells are searched before the whole
+         * image, so codes in their usual places are found before the timeout is spent on the background.
          * @param image image used for datamatrix code detection and decoding
+         * @param options options for this call
          * @return Decoded results that were found in the image
          */
-        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image) const override;
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image,
+                                                       const DecodeOptions &options) const override;
 
         /*!
          * Decode datamatrix codes in the provided image.
@@ -33,25 +40,68 @@ namespace sfdm {
          * results can be queried faster by using the callback.
          * It is recommended to set the number of datamatrix codes that can be detected, because then this function will
          * return faster. How fast the function "gives up" searching for codes in the image, can be tuned with the
-         * setTimeout function.
+         * timeout of the options.
          * @param image image used for datamatrix code detection and decoding
+         * @param options options for this call
          * @param callback callback function that will be called when a DecodeResult is ready
          * @return Decoded results that were found in the image
          */
-        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image,
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image, const DecodeOptions &options,
                                                        std::function<void(DecodeResult)> callback) const override;
 
+        /*!
+         * Decode datamatrix codes in the provided image into caller owned storage.
+         * Apart from the allocations libdmtx does internally, this does not allocate once the buffer has reached its
+         * steady state size.
+         * @param image image used for datamatrix code detection and decoding
+         * @param options options for this call
+         * @param results buffer receiving the decoded results, it is cleared first
+         */
+        void decode(const ImageView &image, const DecodeOptions &options, DecodeResultBuffer &results) const override;
+
+        /*!
+         * Locate datamatrix codes without running the libdmtx matrix decoding. The regions found by the scan are
+         * validated by their finder and timing patterns only, so a region can still turn out to be undecodable.
+         * @param image image used for datamatrix code detection
+         * @param options options for this call
+         * @return Detected codes, holding their libdmtx region for the lazy decode
+         */
+        [[nodiscard]] std::vector<DetectionResult> detect(const ImageView &image,
+                                                          const DecodeOptions &options) const override;
+
+        /*!
+         * Decodes the region stored in the detection, without searching again. Detections of other readers are
+         * searched for again, restricted to the surroundings of their position.
+         * @param image the image the code was detected in
+         * @param detection result of detect, or a position of the code
+         * @param options options for this call
+         * @return Decoded result, or nothing if the code could not be decoded
+         */
+        [[nodiscard]] std::optional<DecodeResult> decode(const ImageView &image, const DetectionResult &detection,
+                                                         const DecodeOptions &options) const override;
+
+        /*!
+         * The decode cache of libdmtx takes one byte per scanned pixel. Above the memory limit, the image is decoded in
+         * strips or downscaled, and callbacks run on the decoding thread instead of their own threads.
+         */
+        [[nodiscard]] MemoryUsage estimateMemoryUsage(const ImageView &image,
+                                                      const DecodeOptions &options) const override;
+
         /*!
          * Decode datamatrix codes in the provided image.
          * This is a coroutine generator, that yields a result and suspends at that point until called again.
          * It is recommended to set the number of datamatrix codes that can be detected, because then this function will
          * return faster. How fast the function "gives up" searching for codes in the image, can be tuned with the
-         * setTimeout function.
-         * @param image image used for datamatrix code detection and decoding
+         * timeout of the options.
+         * @param image image used for datamatrix code detection and decoding, it has to outlive the stream
+         * @param options options for this stream, copied into the stream
          * @return Result stream for consuming
          */
+        [[nodiscard]] ResultStream decodeStream(const ImageView &image, DecodeOptions options) const;
         [[nodiscard]] ResultStream decodeStream(const ImageView &image) const;
 
+        [[nodiscard]] const DecodeOptions &getDefaultOptions() const override;
+
         /*!
          * This is a timeout that will be reset after each detection of one code in an image.
          * This timeout is for detection only, not decoding.
@@ -67,6 +117,14 @@ namespace sfdm {
 
         bool isDecodeWithCallbackSupported() override;
 
+        /*!
+         * Hints are mapped onto the decode properties of libdmtx. libdmtx can only be restricted to one symbol size,
+         * so with several sizes only their shape is used.
+         * @param hints hints for all following decode calls
+         */
+        void setHints(const DecodeHints &hints) override;
+        [[nodiscard]] const DecodeHints &getHints() const override;
+
     private:
         enum class StopCause {
             ScanNotFound,
@@ -75,13 +133,26 @@ namespace sfdm {
             ScanIterLimit,
         };
 
-        [[nodiscard]] std::pair<std::shared_ptr<DmtxRegion_struct>, StopCause>
-        detectNext(const std::shared_ptr<DmtxDecode_struct> &decoder) const;
+        struct RegionDeleter {
+            void operator()(DmtxRegion_struct *region) const;
+        };
+        struct MessageDeleter {
+            void operator()(DmtxMessage_struct *message) const;
+        };
+        using RegionPtr = std::unique_ptr<DmtxRegion_struct, RegionDeleter>;
+        using MessagePtr = std::unique_ptr<DmtxMessage_struct, MessageDeleter>;
+
+        [[nodiscard]] std::pair<RegionPtr, StopCause> detectNext(DmtxDecode_struct *decoder,
+                                                                 const DecodeOptions &options) const;
 
-        [[nodiscard]] std::shared_ptr<DmtxMessage_struct>
-        decode(const std::shared_ptr<DmtxDecode_struct> &decoder,
-               const std::shared_ptr<DmtxRegion_struct> &region) const;
-        uint32_t m_timeoutMSec{200};
-        size_t m_maximumNumberOfCodesToDetect{255};
+        [[nodiscard]] MessagePtr decode(DmtxDecode_struct *decoder, DmtxRegion_struct *region) const;
+
+        /*!
+         * Searches for the next code, that can be decoded.
+         * @return Decoded message and its region, or an empty message when the search is finished
+         */
+        [[nodiscard]] std::pair<MessagePtr, RegionPtr> decodeNext(DmtxDecode_struct *decoder,
+                                                                  const DecodeOptions &options) const;
+        DecodeOptions m_defaultOptions;
     };
 } // namespace sfdm
@@ -12,16 +12,23 @@ namespace sfdm {
      */
     class LibdmtxZXingCombinedCodeReader : public ICodeReader {
     public:
+        using ICodeReader::decode;
+        using ICodeReader::detect;
+
         /*!
          * Decode datamatrix codes in the provided image.
          * This is a blocking call until the decoding of all datamatrix codes in the image are finished.
          * It is recommended to set the number of datamatrix codes that can be detected, because then this function will
          * return faster. How fast the function "gives up" searching for codes in the image, can be tuned with the
-         * setTimeout function.
+         * timeout of the options.
+         * Without double check, the backend that reaches the maximum number of codes first stops the other one: the
+         * libdmtx region search ends within a few milliseconds, ZXing skips its remaining effort levels.
          * @param image image used for datamatrix code detection and decoding
+         * @param options options for this call, passed on to both backends
          * @return Decoded results that were found in the image
          */
-        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image) const override;
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image,
+                                                       const DecodeOptions &options) const override;
 
         /*!
          * Decode datamatrix codes in the provided image.
@@ -29,14 +36,46 @@ namespace sfdm {
          * results can be queried faster by using the callback.
          * It is recommended to set the number of datamatrix codes that can be detected, because then this function will
          * return faster. How fast the function "gives up" searching for codes in the image, can be tuned with the
-         * setTimeout function.
+         * timeout of the options.
          * @param image image used for datamatrix code detection and decoding
+         * @param options options for this call, passed on to both backends
          * @param callback callback function that will be called when a DecodeResult is ready
          * @return Decoded results that were found in the image
          */
-        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image,
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image, const DecodeOptions &options,
                                                        std::function<void(DecodeResult)> callback) const override;
 
+        /*!
+         * Runs the detection of both backends in parallel and merges their detections. Codes found by both are
+         * returned once, with the libdmtx region.
+         * @param image image used for datamatrix code detection
+         * @param options options for this call, passed on to both backends
+         * @return Detected codes
+         */
+        [[nodiscard]] std::vector<DetectionResult> detect(const ImageView &image,
+                                                          const DecodeOptions &options) const override;
+
+        /*!
+         * Decodes the detection with libdmtx. ZXing is only used, if libdmtx fails. This way texts that ZXing decoded
+         * during the detection are double checked.
+         * @param image the image the code was detected in
+         * @param detection result of detect, or a position of the code
+         * @param options options for this call
+         * @return Decoded result, or nothing if the code could not be decoded
+         */
+        [[nodiscard]] std::optional<DecodeResult> decode(const ImageView &image, const DetectionResult &detection,
+                                                         const DecodeOptions &options) const override;
+
+        /*!
+         * Both backends decode concurrently, if the sum of their working memory stays below the memory limit.
+         * Otherwise decode runs ZXing and then libdmtx on the calling thread, each of them within the whole limit.
+         * The usage is within the limit, as long as one of the backends is.
+         */
+        [[nodiscard]] MemoryUsage estimateMemoryUsage(const ImageView &image,
+                                                      const DecodeOptions &options) const override;
+
+        [[nodiscard]] const DecodeOptions &getDefaultOptions() const override;
+
         /*!
          * This is a timeout that will be reset after each detection of one code in an image.
          * This timeout is for detection only, not decoding. It is only applied to the libdmtx backend.
@@ -52,6 +91,13 @@ namespace sfdm {
 
         bool isDecodeWithCallbackSupported() override;
 
+        /*!
+         * Hints are passed on to both backends. The symbol sizes are validated by the libdmtx backend.
+         * @param hints hints for all following decode calls
+         */
+        void setHints(const DecodeHints &hints) override;
+        [[nodiscard]] const DecodeHints &getHints() const override;
+
         /*!
          * Sets whether zxing results shall be double checked by libdmtx. This was proven to be necessary, as the tests
          * from this library showed, that zxing decodes some codes wrongly (wrong text). libdmtx decodes them better.
@@ -64,6 +110,7 @@ namespace sfdm {
     private:
         LibdmtxCodeReader m_libdmtxCodeReader;
         ZXingCodeReader m_zxingCodeReader;
+        DecodeOptions m_defaultOptions;
         std::atomic<bool> m_doubleCheckZXing{true};
     };
 } // namespace sfdm
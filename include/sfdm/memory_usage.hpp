@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+
+namespace sfdm {
+    /*!
+     * Estimated working memory of a decode call, in bytes. Only buffers, that grow with the image, are counted. Small
+     * allocations of the backends are not.
+     */
+    struct MemoryUsage {
+        /*!
+         * libdmtx decode cache, one byte per scanned pixel
+         */
+        size_t libdmtxCache{};
+        /*!
+         * ZXing binarized image and the downscaled images of its effort levels
+         */
+        size_t zxingBuffers{};
+        /*!
+         * Copies of the image, e.g. downscaled images or inverted variants
+         */
+        size_t imageCopies{};
+        /*!
+         * Stacks of the threads running callbacks
+         */
+        size_t callbackThreads{};
+        /*!
+         * Largest sum of the buffers above, that exist at the same time
+         */
+        size_t peak{};
+
+        /*!
+         * Backends or image variants were decoded one after another instead of concurrently
+         */
+        bool serialized{};
+        /*!
+         * The image was decoded in horizontal strips
+         */
+        bool striped{};
+        /*!
+         * A downscaled copy of the image was decoded
+         */
+        bool downscaled{};
+        /*!
+         * False, if even the cheapest strategy exceeds the memory limit. No codes are decoded then.
+         */
+        bool withinLimit{true};
+    };
+} // namespace sfdm
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <sfdm/icode_reader.hpp>
+#include <string>
+#include <string_view>
+
+namespace sfdm {
+    enum class ReaderBackend {
+        ZXing,
+        Libdmtx,
+        Combined,
+    };
+
+    /*!
+     * Serializable description of a code reader and its settings.
+     * Config files are plain "key=value" lines, e.g. as written by the sfdm_tune tool:
+     *   backend=combined
+     *   timeout=100
+     *   double_check_zxing=false
+     *   try_inverted=true
+     * Empty lines and lines starting with '#' are ignored.
+     */
+    struct ReaderConfig {
+        ReaderBackend backend{ReaderBackend::Combined};
+        uint32_t timeoutMSec{200};
+        bool doubleCheckZXing{true};
+        /*!
+         * Search the inverted image concurrently, for light codes on dark background
+         */
+        bool tryInverted{false};
+        /*!
+         * Search the mirrored image concurrently, and the inverted mirrored image if tryInverted is set
+         */
+        bool tryMirrored{false};
+        auto operator<=>(const ReaderConfig &) const = default;
+    };
+
+    [[nodiscard]] std::string toString(ReaderBackend backend);
+    [[nodiscard]] ReaderBackend readerBackendFromString(std::string_view value);
+
+    [[nodiscard]] ReaderConfig readReaderConfig(std::istream &stream);
+    void writeReaderConfig(std::ostream &stream, const ReaderConfig &config);
+
+    /*!
+     * Writes the per call options, that change how a frame is decoded, as "key=value" lines: timeout, maximum number
+     * of codes, hints, effort levels, memory limit and quality gate. Unset optional values are not written. The
+     * deadline is a point in time and is not written, neither are expected payloads, the location prior and the stop
+     * token.
+     */
+    void writeDecodeOptions(std::ostream &stream, const DecodeOptions &options);
+
+    /*!
+     * Applies one line written by writeDecodeOptions to the options.
+     * @return false, if the key is no decode option
+     */
+    [[nodiscard]] bool readDecodeOption(DecodeOptions &options, std::string_view key, std::string_view value);
+
+    /*!
+     * Load a reader configuration from a file.
+     * @param path path of the configuration file
+     * @return Parsed configuration. Keys that are not present keep their default value.
+     */
+    [[nodiscard]] ReaderConfig loadReaderConfig(const std::filesystem::path &path);
+    void saveReaderConfig(const std::filesystem::path &path, const ReaderConfig &config);
+
+    /*!
+     * Create a code reader as described by the configuration. With tryInverted or tryMirrored, the backend is
+     * wrapped by a VariantRacingCodeReader.
+     * Throws, if the requested backend was not built into this library.
+     * @param config configuration of the reader
+     * @return Configured code reader
+     */
+    [[nodiscard]] std::unique_ptr<ICodeReader> createCodeReader(const ReaderConfig &config);
+} // namespace sfdm
@@ -0,0 +1,131 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <sfdm/icode_reader.hpp>
+#include <sfdm/reader_config.hpp>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+namespace sfdm {
+    struct CaptureQueue;
+    struct Capture;
+
+    struct SlowFrameRecorderConfig {
+        /*!
+         * Directory of the capture ring, created if it does not exist
+         */
+        std::filesystem::path directory;
+        /*!
+         * Frames, whose decode call took longer, are recorded
+         */
+        std::chrono::milliseconds latencyThreshold{100};
+        /*!
+         * Whether frames with fewer codes than the maximum number of codes of the options are recorded. Only enable it,
+         * if the options of each call carry the real number of codes per frame as maximum. With the default of 255
+         * every frame lacks codes and is recorded.
+         */
+        bool recordMissingCodes{false};
+        /*!
+         * Number of captures kept on disk. The oldest capture is overwritten by the next one.
+         */
+        size_t maximumCaptures{32};
+        /*!
+         * Number of captures waiting for the writer at most. Further slow frames are not recorded.
+         */
+        size_t queueCapacity{4};
+        /*!
+         * Written next to every capture, so sfdm_replay can recreate the reader
+         */
+        std::optional<ReaderConfig> readerConfig;
+    };
+
+    struct RecorderStatistics {
+        uint64_t recordedFrames{};
+        /*!
+         * Slow frames, that were not recorded, because the writer was behind
+         */
+        uint64_t droppedFrames{};
+    };
+
+    /*!
+     * Code Reader, that records slow frames for offline replay. Every decode call is timed. Frames that exceed the
+     * latency threshold or lack codes are copied and handed to a writer thread, that writes them into a ring of
+     * captures on disk: the frame as <slot>.pgm, the reader configuration as <slot>.cfg and the timings, options and
+     * results as <slot>.txt. The .txt file is written last, so a capture is complete once it exists.
+     * Detection and the lazy decode of detections are not recorded. The options of the call are recorded, except for
+     * expected payloads, the location prior and the stop token, so replays of calls, that use them, may differ.
+     */
+    class RecordingCodeReader : public ICodeReader {
+    public:
+        using ICodeReader::decode;
+        using ICodeReader::detect;
+
+        /*!
+         * Starts the writer thread.
+         * @param backend reader, that decodes the frames
+         * @param config thresholds and layout of the capture ring
+         */
+        RecordingCodeReader(std::unique_ptr<ICodeReader> backend, SlowFrameRecorderConfig config);
+
+        /*!
+         * Writes the captures, that are still queued, and stops the writer thread.
+         */
+        ~RecordingCodeReader() override;
+
+        RecordingCodeReader(const RecordingCodeReader &) = delete;
+        RecordingCodeReader &operator=(const RecordingCodeReader &) = delete;
+
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image,
+                                                       const DecodeOptions &options) const override;
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image, const DecodeOptions &options,
+                                                       std::function<void(DecodeResult)> callback) const override;
+        void decode(const ImageView &image, const DecodeOptions &options, DecodeResultBuffer &results) const override;
+
+        [[nodiscard]] std::vector<DetectionResult> detect(const ImageView &image,
+                                                          const DecodeOptions &options) const override;
+        [[nodiscard]] std::optional<DecodeResult> decode(const ImageView &image, const DetectionResult &detection,
+                                                         const DecodeOptions &options) const override;
+        [[nodiscard]] MemoryUsage estimateMemoryUsage(const ImageView &image,
+                                                      const DecodeOptions &options) const override;
+
+        [[nodiscard]] const DecodeOptions &getDefaultOptions() const override;
+
+        void setTimeout(uint32_t msec) override;
+        [[nodiscard]] uint32_t getTimeout() const override;
+        bool isTimeoutSupported() override;
+
+        void setMaximumNumberOfCodesToDetect(size_t count) override;
+        [[nodiscard]] size_t getMaximumNumberOfCodesToDetect() const override;
+
+        bool isDecodeWithCallbackSupported() override;
+
+        void setHints(const DecodeHints &hints) override;
+        [[nodiscard]] const DecodeHints &getHints() const override;
+
+        [[nodiscard]] RecorderStatistics getRecorderStatistics() const;
+
+    private:
+        [[nodiscard]] bool isSlow(std::chrono::steady_clock::duration elapsed, size_t resultCount,
+                                  const DecodeOptions &options) const;
+        [[nodiscard]] bool hasFreeCaptureSlot() const;
+        void record(const ImageView &image, const DecodeOptions &options, std::vector<DecodeResult> results,
+                    std::chrono::steady_clock::duration elapsed) const;
+        void write(const Capture &capture) const;
+        void work();
+
+        std::unique_ptr<ICodeReader> m_backend;
+        SlowFrameRecorderConfig m_config;
+        std::unique_ptr<CaptureQueue> m_queue;
+        mutable std::counting_semaphore<> m_capturesAvailable{0};
+        mutable std::atomic<uint64_t> m_nextSequence{0};
+        mutable std::atomic<uint64_t> m_recordedFrames{0};
+        mutable std::atomic<uint64_t> m_droppedFrames{0};
+        std::atomic<bool> m_stopped{false};
+        std::jthread m_writer;
+    };
+} // namespace sfdm
@@ -2,9 +2,24 @@
 
 #include <sfdm/sfdm_config.hpp>
 
+#include <sfdm/code_location_prior.hpp>
+#include <sfdm/composite_reader.hpp>
+#include <sfdm/decode_hints.hpp>
+#include <sfdm/decode_options.hpp>
 #include <sfdm/decode_result.hpp>
+#include <sfdm/decode_result_buffer.hpp>
+#include <sfdm/detection_result.hpp>
+#include <sfdm/expected_payloads.hpp>
 #include <sfdm/icode_reader.hpp>
+#include <sfdm/image_quality.hpp>
 #include <sfdm/image_view.hpp>
+#include <sfdm/memory_usage.hpp>
+#include <sfdm/reader_config.hpp>
+#include <sfdm/recording_code_reader.hpp>
+#include <sfdm/stream_decoder.hpp>
+#include <sfdm/strip_decoder.hpp>
+#include <sfdm/template_code_reader.hpp>
+#include <sfdm/variant_racing_code_reader.hpp>
 
 #ifdef SFDM_WITH_ZXING_DECODER
 #include <sfdm/zxing_code_reader.hpp>
@@ -0,0 +1,121 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <sfdm/decode_result.hpp>
+#include <sfdm/icode_reader.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sfdm::shm {
+    struct RingMapping;
+
+    struct ShmDecodeServerConfig {
+        /*!
+         * POSIX shared memory name, e.g. "/sfdm_camera0"
+         */
+        std::string name;
+        uint32_t slotCount{4};
+        size_t maxFrameBytes{4096 * 3072};
+        uint32_t maxResultsPerFrame{32};
+        uint32_t maxTextLength{1024};
+        size_t workerCount{2};
+    };
+
+    /*!
+     * Decode server, that takes frames from a POSIX shared memory ring buffer and writes the results into a result
+     * ring with one entry per frame slot. Frames are decoded in place by a pool of workers, each owning its own reader.
+     * Linux only.
+     */
+    class ShmDecodeServer {
+    public:
+        using ReaderFactory = std::function<std::unique_ptr<ICodeReader>()>;
+
+        /*!
+         * Creates (or replaces) the shared memory ring and starts the workers.
+         * @param config layout of the ring and number of workers
+         * @param readerFactory called once per worker to create its reader
+         */
+        ShmDecodeServer(ShmDecodeServerConfig config, const ReaderFactory &readerFactory);
+        ~ShmDecodeServer();
+
+        ShmDecodeServer(const ShmDecodeServer &) = delete;
+        ShmDecodeServer &operator=(const ShmDecodeServer &) = delete;
+
+        /*!
+         * Stops the workers and removes the shared memory. Frames that are still queued are not decoded.
+         */
+        void stop();
+
+        [[nodiscard]] const ShmDecodeServerConfig &getConfig() const;
+
+    private:
+        void work(ICodeReader &reader, const std::stop_token &stopToken);
+
+        ShmDecodeServerConfig m_config;
+        std::unique_ptr<RingMapping> m_mapping;
+        std::vector<std::unique_ptr<ICodeReader>> m_readers;
+        std::vector<std::jthread> m_workers;
+    };
+
+    /*!
+     * Client of a ShmDecodeServer. Frames are written directly into a slot of the shared memory ring, so the pixels
+     * are never copied. The client is not thread safe, use one client per thread.
+     */
+    class ShmDecodeClient {
+    public:
+        struct FrameSlot {
+            uint32_t index{};
+            uint8_t *pixels{};
+            size_t capacity{};
+        };
+
+        /*!
+         * Opens the shared memory ring of a running server.
+         * @param name POSIX shared memory name the server was started with
+         */
+        explicit ShmDecodeClient(const std::string &name);
+        ~ShmDecodeClient();
+
+        ShmDecodeClient(const ShmDecodeClient &) = delete;
+        ShmDecodeClient &operator=(const ShmDecodeClient &) = delete;
+
+        /*!
+         * Reserves a free frame slot. The frame has to be written to FrameSlot::pixels as 8 bit mono image with a row
+         * stride equal to its width.
+         * @param timeout time to wait for a slot to become free
+         * @return Reserved slot, or nothing if no slot became free in time
+         */
+        [[nodiscard]] std::optional<FrameSlot> acquireFrame(std::chrono::milliseconds timeout);
+
+        /*!
+         * Hands the frame in the slot over to the server.
+         * @param slot slot returned by acquireFrame
+         * @param width width of the frame
+         * @param height height of the frame
+         * @param maximumNumberOfCodesToDetect passed on to the reader of the server
+         */
+        void submitFrame(const FrameSlot &slot, size_t width, size_t height, size_t maximumNumberOfCodesToDetect);
+
+        /*!
+         * Waits for the results of a submitted frame and releases the slot for reuse afterwards.
+         * @param slot slot passed to submitFrame
+         * @param timeout time to wait for the server
+         * @return Decoded results, or nothing if the server did not finish in time. The slot stays reserved in that
+         * case and waitForResults can be called again.
+         */
+        [[nodiscard]] std::optional<std::vector<DecodeResult>> waitForResults(const FrameSlot &slot,
+                                                                              std::chrono::milliseconds timeout);
+
+        /*!
+         * Gives an acquired, but not submitted slot back.
+         */
+        void releaseFrame(const FrameSlot &slot);
+
+    private:
+        std::unique_ptr<RingMapping> m_mapping;
+    };
+} // namespace sfdm::shm
@@ -0,0 +1,159 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <sfdm/decode_options.hpp>
+#include <sfdm/decode_result.hpp>
+#include <sfdm/icode_reader.hpp>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sfdm {
+    struct StreamFrameQueue;
+
+    enum class OverloadPolicy {
+        /*!
+         * A full queue drops its oldest frame to make room for the new one
+         */
+        DropOldest,
+        /*!
+         * A full queue rejects the new frame
+         */
+        DropNewest,
+        /*!
+         * The queue holds one frame, that is replaced by every new frame. Workers always decode the latest frame.
+         */
+        LatestOnly,
+    };
+
+    struct StreamDecoderConfig {
+        /*!
+         * Number of frames waiting for a worker at most. Ignored for OverloadPolicy::LatestOnly.
+         */
+        size_t queueCapacity{4};
+        size_t workerCount{1};
+        OverloadPolicy policy{OverloadPolicy::DropOldest};
+        /*!
+         * Frames older than this, measured from their capture time, are dropped instead of decoded, and the deadline
+         * of the decode call is set to the capture time plus this latency. 0 disables the limit.
+         */
+        std::chrono::milliseconds maximumLatency{0};
+    };
+
+    struct StreamFrame {
+        size_t width{};
+        size_t height{};
+        /*!
+         * 8 bit mono pixels without padding, at least width * height bytes
+         */
+        std::vector<uint8_t> pixels;
+        std::chrono::steady_clock::time_point captureTime{std::chrono::steady_clock::now()};
+    };
+
+    struct StreamResult {
+        /*!
+         * Index of the frame in the order of submission, starting with 0
+         */
+        uint64_t sequence{};
+        std::vector<DecodeResult> results;
+        std::chrono::steady_clock::time_point captureTime{};
+        /*!
+         * Time from the capture of the frame until its results were ready
+         */
+        std::chrono::nanoseconds latency{};
+        /*!
+         * Message of the exception thrown by the reader, empty on success
+         */
+        std::string error;
+    };
+
+    struct StreamStatistics {
+        size_t queueDepth{};
+        size_t maximumQueueDepth{};
+        uint64_t submittedFrames{};
+        uint64_t decodedFrames{};
+        /*!
+         * Frames dropped by the overload policy
+         */
+        uint64_t droppedFrames{};
+        /*!
+         * Frames dropped, because they exceeded the maximum latency before a worker took them
+         */
+        uint64_t expiredFrames{};
+        std::chrono::nanoseconds lastLatency{};
+        std::chrono::nanoseconds maximumLatency{};
+        std::chrono::nanoseconds meanLatency{};
+    };
+
+    /*!
+     * Decodes a live stream of frames with a pool of workers sharing one reader. Frames wait in a bounded lock free
+     * queue, so under overload frames are dropped according to the policy instead of queueing up, and the latency
+     * from capture to result stays bounded.
+     */
+    class StreamDecoder {
+    public:
+        /*!
+         * Called from the worker threads, concurrently if there is more than one worker. With several workers,
+         * results can be reported out of order.
+         */
+        using ResultCallback = std::function<void(StreamResult)>;
+
+        /*!
+         * Starts the workers.
+         * @param reader reader shared by all workers, it has to outlive the stream decoder
+         * @param config queue, workers and overload policy
+         * @param options options used for every frame
+         * @param callback receives the results of every decoded frame
+         */
+        StreamDecoder(const ICodeReader &reader, StreamDecoderConfig config, DecodeOptions options,
+                      ResultCallback callback);
+        ~StreamDecoder();
+
+        StreamDecoder(const StreamDecoder &) = delete;
+        StreamDecoder &operator=(const StreamDecoder &) = delete;
+
+        /*!
+         * Queues a frame. Never blocks. Several producers may submit concurrently, each frame gets a unique sequence
+         * number. Must not be called concurrently with close.
+         * @param frame frame to decode, the pixels are moved into the queue
+         * @return false, if the frame was dropped or the decoder is closed
+         */
+        bool submit(StreamFrame frame);
+
+        /*!
+         * Stops accepting frames, decodes the frames that are still queued and stops the workers.
+         */
+        void close();
+
+        [[nodiscard]] StreamStatistics getStatistics() const;
+
+    private:
+        void work();
+        void recordLatency(std::chrono::nanoseconds latency);
+
+        const ICodeReader &m_reader;
+        StreamDecoderConfig m_config;
+        DecodeOptions m_options;
+        ResultCallback m_callback;
+        std::unique_ptr<StreamFrameQueue> m_queue;
+        // one permit per queued frame, dropped frames leave spare permits, that wake a worker for nothing
+        std::counting_semaphore<> m_framesAvailable{0};
+        std::atomic<bool> m_closed{false};
+        std::atomic<uint64_t> m_nextSequence{0};
+
+        std::atomic<size_t> m_maximumQueueDepth{0};
+        std::atomic<uint64_t> m_submittedFrames{0};
+        std::atomic<uint64_t> m_decodedFrames{0};
+        std::atomic<uint64_t> m_droppedFrames{0};
+        std::atomic<uint64_t> m_expiredFrames{0};
+        std::atomic<int64_t> m_lastLatency{0};
+        std::atomic<int64_t> m_maximumLatency{0};
+        std::atomic<int64_t> m_latencySum{0};
+
+        std::vector<std::jthread> m_workers;
+    };
+} // namespace sfdm
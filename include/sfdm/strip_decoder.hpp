@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <sfdm/decode_options.hpp>
+#include <sfdm/decode_result.hpp>
+#include <sfdm/icode_reader.hpp>
+#include <vector>
+
+namespace sfdm {
+    struct StripDecoderConfig {
+        /*!
+         * Width of the image in pixels, every pushed row has this width
+         */
+        size_t width{};
+        /*!
+         * Number of rows decoded together
+         */
+        size_t stripHeight{1024};
+        /*!
+         * Number of rows shared by consecutive strips. Has to be larger than the tallest code, so every code lies
+         * completely inside one strip.
+         */
+        size_t overlap{256};
+    };
+
+    /*!
+     * Decodes images, that arrive in row blocks, e.g. from line scan cameras or when reading very large images.
+     * Overlapping strips are decoded as soon as they are complete. Results are reported in coordinates of the whole
+     * image, codes found in two strips are reported once. Only one strip is kept in memory, so the memory does not grow
+     * with the height of the image.
+     */
+    class StripDecoder {
+    public:
+        /*!
+         * @param reader reader used for every strip, it has to outlive the strip decoder
+         * @param config layout of the strips
+         * @param options options used for every strip, e.g. the maximum number of codes is per strip
+         */
+        StripDecoder(const ICodeReader &reader, StripDecoderConfig config, DecodeOptions options = {});
+
+        /*!
+         * Appends rows to the image and decodes all strips, that are complete afterwards.
+         * @param rows rowCount rows of 8 bit mono pixels without padding
+         * @param rowCount number of rows
+         * @return Codes found in the completed strips, that were not reported before
+         */
+        [[nodiscard]] std::vector<DecodeResult> push(const uint8_t *rows, size_t rowCount);
+
+        /*!
+         * Decodes the rows of the last, incomplete strip. Afterwards, the decoder starts a new image.
+         * @return Codes found in the last strip, that were not reported before
+         */
+        [[nodiscard]] std::vector<DecodeResult> finish();
+
+        /*!
+         * Number of rows pushed since the image was started
+         */
+        [[nodiscard]] size_t getRowCount() const;
+
+    private:
+        [[nodiscard]] std::vector<DecodeResult> decodeStrip(size_t rowCount);
+
+        const ICodeReader &m_reader;
+        StripDecoderConfig m_config;
+        DecodeOptions m_options;
+        std::vector<uint8_t> m_strip;
+        size_t m_stripTop{};
+        size_t m_bufferedRows{};
+        // rows of the current strip, that were already part of a decoded strip
+        size_t m_decodedRows{};
+        // results of the previous strip, that lie in the overlap
+        std::vector<DecodeResult> m_overlapResults;
+    };
+} // namespace sfdm
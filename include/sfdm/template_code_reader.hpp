@@ -0,0 +1,84 @@
+#pragma once
+#include <memory>
+#include <optional>
+#include <sfdm/icode_reader.hpp>
+#include <vector>
+
+namespace sfdm {
+    struct CodeSlot {
+        CodePosition expectedPosition{};
+        /*!
+         * How far (in pixels) the code may be away from the expected position. The region of interest decoded for
+         * this slot is the bounding box of the expected position grown by this value on every side.
+         */
+        uint32_t tolerance{20};
+    };
+
+    struct CodeLayout {
+        std::vector<CodeSlot> slots;
+
+        /*!
+         * Creates a layout from the results of a calibration frame. Slots are numbered row by row, from top left to
+         * bottom right.
+         * @param results results decoded from a frame with all slots filled
+         * @param tolerance tolerance of every slot
+         * @return Layout with one slot per result
+         */
+        [[nodiscard]] static CodeLayout fromCalibration(const std::vector<DecodeResult> &results, uint32_t tolerance);
+    };
+
+    struct SlotResult {
+        size_t slotIndex{};
+        /*!
+         * Empty, if no code was found in the slot
+         */
+        std::optional<DecodeResult> result;
+    };
+
+    /*!
+     * Code Reader for codes at fixed positions, e.g. trays with a grid of slots.
+     * Instead of searching the whole image, every slot of the layout is decoded directly in its own small region of
+     * interest. Slots are decoded in parallel.
+     */
+    class TemplateCodeReader {
+    public:
+        /*!
+         * @param backend reader used to decode each slot. Each slot is decoded with at most one code to detect.
+         * @param layout expected positions of the codes
+         * @param threadCount maximum number of slots decoded in parallel. 0 uses the number of hardware threads.
+         */
+        TemplateCodeReader(std::unique_ptr<ICodeReader> backend, CodeLayout layout, size_t threadCount = 0);
+
+        /*!
+         * Decode every slot of the layout.
+         * This is a blocking call until all slots are decoded. If decoding a slot throws, no further slots are started
+         * and the first exception is rethrown on the calling thread.
+         * @param image image used for datamatrix code detection and decoding
+         * @param options options for each slot. The maximum number of codes is always 1.
+         * @return One result per slot, in the order of the layout. Empty slots have no result.
+         */
+        [[nodiscard]] std::vector<SlotResult> decodeSlots(const ImageView &image, const DecodeOptions &options) const;
+
+        /*!
+         * Decode every slot of the layout with the default options of the backend.
+         */
+        [[nodiscard]] std::vector<SlotResult> decodeSlots(const ImageView &image) const;
+
+        /*!
+         * Decode every slot of the layout.
+         * @param image image used for datamatrix code detection and decoding
+         * @return Decoded results of all slots that were not empty
+         */
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image) const;
+
+        [[nodiscard]] const CodeLayout &getLayout() const;
+
+    private:
+        [[nodiscard]] std::optional<DecodeResult> decodeSlot(const ImageView &image, const CodeSlot &slot,
+                                                             const DecodeOptions &options) const;
+
+        std::unique_ptr<ICodeReader> m_backend;
+        CodeLayout m_layout;
+        size_t m_threadCount;
+    };
+} // namespace sfdm
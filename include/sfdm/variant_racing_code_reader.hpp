@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <sfdm/icode_reader.hpp>
+#include <vector>
+
+namespace sfdm {
+    /*!
+     * Variant of the image a code is searched in.
+     */
+    enum class ImageVariant {
+        Normal,
+        /*!
+         * Light codes on dark background, e.g. laser etched parts
+         */
+        Inverted,
+        /*!
+         * Flipped horizontally, for codes read through the back of a transparent part
+         */
+        Mirrored,
+        InvertedMirrored,
+    };
+
+    /*!
+     * Writes the variant of the image into pixels, which is resized to the size of the image.
+     * @param image image to transform
+     * @param variant variant to create
+     * @param pixels scratch buffer receiving the pixels
+     * @return View of the variant. The image itself for ImageVariant::Normal.
+     */
+    [[nodiscard]] ImageView createImageVariant(const ImageView &image, ImageVariant variant,
+                                               std::vector<uint8_t> &pixels);
+
+    /*!
+     * Maps a position found in a variant back onto the image the variant was created from.
+     */
+    [[nodiscard]] CodePosition toOriginalPosition(const CodePosition &position, ImageVariant variant,
+                                                  const ImageView &image);
+
+    /*!
+     * Code Reader, that searches several variants of the image concurrently, e.g. the image and its inverted copy.
+     * Each variant is decoded by the backend on its own thread. Results are mapped back onto the original image and
+     * codes found in several variants are returned once. As soon as the variants found the maximum number of codes
+     * (or all expected payloads), the remaining variants are stopped through DecodeOptions::stopToken. ZXing only
+     * checks the stop token between effort levels, so a level in progress finishes first.
+     * The variants are searched without the location prior of the options. Once the race ends, the merged codes are
+     * fed into the prior as one frame.
+     */
+    class VariantRacingCodeReader : public ICodeReader {
+    public:
+        using ICodeReader::decode;
+        using ICodeReader::detect;
+
+        /*!
+         * @param backend reader, that decodes the variants. It is shared by the variant threads.
+         * @param variants variants searched on every call
+         */
+        explicit VariantRacingCodeReader(std::unique_ptr<ICodeReader> backend,
+                                         std::vector<ImageVariant> variants = {ImageVariant::Normal,
+                                                                               ImageVariant::Inverted});
+
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image,
+                                                       const DecodeOptions &options) const override;
+
+        /*!
+         * The callback is called for each result, once the race is over.
+         */
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image, const DecodeOptions &options,
+                                                       std::function<void(DecodeResult)> callback) const override;
+
+        /*!
+         * Detections remember the variant they were found in, so their lazy decode searches the same variant.
+         */
+        [[nodiscard]] std::vector<DetectionResult> detect(const ImageView &image,
+                                                          const DecodeOptions &options) const override;
+        [[nodiscard]] std::optional<DecodeResult> decode(const ImageView &image, const DetectionResult &detection,
+                                                         const DecodeOptions &options) const override;
+
+        /*!
+         * Every variant thread holds its copy of the image and the working memory of the backend. If that exceeds the
+         * memory limit, decode searches one variant after the other on the calling thread. The backend then gets the
+         * limit, that the copy of the variant leaves.
+         */
+        [[nodiscard]] MemoryUsage estimateMemoryUsage(const ImageView &image,
+                                                      const DecodeOptions &options) const override;
+
+        [[nodiscard]] const DecodeOptions &getDefaultOptions() const override;
+
+        void setTimeout(uint32_t msec) override;
+        [[nodiscard]] uint32_t getTimeout() const override;
+        bool isTimeoutSupported() override;
+
+        void setMaximumNumberOfCodesToDetect(size_t count) override;
+        [[nodiscard]] size_t getMaximumNumberOfCodesToDetect() const override;
+
+        bool isDecodeWithCallbackSupported() override;
+
+        void setHints(const DecodeHints &hints) override;
+        [[nodiscard]] const DecodeHints &getHints() const override;
+
+        [[nodiscard]] const std::vector<ImageVariant> &getVariants() const;
+
+    private:
+        std::unique_ptr<ICodeReader> m_backend;
+        std::vector<ImageVariant> m_variants;
+    };
+} // namespace sfdm
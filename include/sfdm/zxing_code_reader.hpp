@@ -1,10 +1,38 @@
 #pragma once
 #include <memory>
 #include <sfdm/icode_reader.hpp>
+#include <vector>
 
 namespace sfdm {
     struct ZXingCodeReaderImpl;
 
+    enum class ZXingBinarizer {
+        LocalAverage,
+        GlobalHistogram,
+        FixedThreshold,
+        BoolCast,
+    };
+
+    /*!
+     * One set of ZXing options, from cheap (global histogram, no try harder) to expensive (local average, try harder).
+     */
+    struct ZXingEffortLevel {
+        ZXingBinarizer binarizer{ZXingBinarizer::LocalAverage};
+        bool tryHarder{true};
+        bool tryRotate{true};
+        bool tryDownscale{true};
+        auto operator<=>(const ZXingEffortLevel &) const = default;
+    };
+
+    struct LeveledDecodeResult {
+        DecodeResult result;
+        /*!
+         * Index of the effort level in the ladder, that found this code
+         */
+        size_t effortLevel{};
+        auto operator<=>(const LeveledDecodeResult &) const = default;
+    };
+
     /*!
      * Code Reader using zxing in the backend.
      * Best for speed, but not that accurate.
@@ -15,17 +43,20 @@ namespace sfdm {
 
         ~ZXingCodeReader() override;
 
-        // DetectionResult detect(const cv::Mat &image) override;
+        using ICodeReader::decode;
+        using ICodeReader::detect;
 
         /*!
          * Decode datamatrix codes in the provided image.
          * This is a blocking call until the decoding of all datamatrix codes in the image are finished.
          * It is recommended to set the number of datamatrix codes that can be detected, because then this function will
-         * return faster.
+         * return faster. The timeout of the options is ignored, the deadline is checked between the effort levels.
          * @param image image used for datamatrix code detection and decoding
+         * @param options options for this call
          * @return Decoded results that were found in the image
          */
-        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image) const override;
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image,
+                                                       const DecodeOptions &options) const override;
 
         /*!
          * Decode datamatrix codes in the provided image.
@@ -34,11 +65,52 @@ namespace sfdm {
          * It is recommended to set the number of datamatrix codes that can be detected, because then this function will
          * return faster.
          * @param image image used for datamatrix code detection and decoding
+         * @param options options for this call
          * @param callback callback function that will be called when a DecodeResult is ready
          * @return Decoded results that were found in the image
          */
-        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image,
+        [[nodiscard]] std::vector<DecodeResult> decode(const ImageView &image, const DecodeOptions &options,
                                                        std::function<void(DecodeResult)> callback) const override;
+
+        /*!
+         * Decode datamatrix codes in the provided image into caller owned storage.
+         * The results are not copied into intermediate DecodeResults. Note that ZXing itself still allocates.
+         * @param image image used for datamatrix code detection and decoding
+         * @param options options for this call
+         * @param results buffer receiving the decoded results, it is cleared first
+         */
+        void decode(const ImageView &image, const DecodeOptions &options, DecodeResultBuffer &results) const override;
+
+        /*!
+         * ZXing has no public entry point for locating codes without decoding them. The codes are decoded once and the
+         * texts are kept in the detections, so the lazy decode does not decode again.
+         * @param image image used for datamatrix code detection
+         * @param options options for this call
+         * @return Detected codes
+         */
+        [[nodiscard]] std::vector<DetectionResult> detect(const ImageView &image,
+                                                          const DecodeOptions &options) const override;
+
+        /*!
+         * Returns the text kept by detect. Detections of other readers are decoded in the surroundings of their
+         * position, with the levels of the effort ladder.
+         * @param image the image the code was detected in
+         * @param detection result of detect, or a position of the code
+         * @param options options for this call
+         * @return Decoded result, or nothing if the code could not be decoded
+         */
+        [[nodiscard]] std::optional<DecodeResult> decode(const ImageView &image, const DetectionResult &detection,
+                                                         const DecodeOptions &options) const override;
+
+        /*!
+         * ZXing binarizes the scanned pixels. Effort levels with tryDownscale add the downscaled images and their
+         * binarizations. Above the memory limit, the image is decoded in strips or downscaled.
+         */
+        [[nodiscard]] MemoryUsage estimateMemoryUsage(const ImageView &image,
+                                                      const DecodeOptions &options) const override;
+
+        [[nodiscard]] const DecodeOptions &getDefaultOptions() const override;
+
         void setTimeout(uint32_t msec) override;
         [[nodiscard]] uint32_t getTimeout() const override;
         bool isTimeoutSupported() override;
@@ -48,6 +120,42 @@ namespace sfdm {
 
         bool isDecodeWithCallbackSupported() override;
 
+        /*!
+         * Sets the levels the reader escalates through. The image is decoded with the first level. The next level is
+         * only tried while fewer codes than the maximum number of codes were found. Results of all levels are merged.
+         * The default ladder is the single level ZXingEffortLevel{}, the LocalAverage and try harder pass. Must not be
+         * called while other threads decode.
+         * @param ladder levels, from cheap to expensive. Must not be empty.
+         */
+        void setEffortLadder(std::vector<ZXingEffortLevel> ladder);
+        [[nodiscard]] const std::vector<ZXingEffortLevel> &getEffortLadder() const;
+
+        /*!
+         * ZXing has no options for symbol sizes or shapes, so results that do not match the shape and module size
+         * hints are dropped. Edge threshold, square deviation and scan gap are ignored.
+         * @param hints hints for all following decode calls
+         */
+        void setHints(const DecodeHints &hints) override;
+        [[nodiscard]] const DecodeHints &getHints() const override;
+
+        /*!
+         * Ladder, that starts with a fast global histogram pass and ends with the default LocalAverage and try harder
+         * pass. It is only faster than the default, if the maximum number of codes is set and the cheap levels find
+         * them. Otherwise all levels run.
+         */
+        [[nodiscard]] static std::vector<ZXingEffortLevel> progressiveEffortLadder();
+
+        /*!
+         * Decode datamatrix codes in the provided image and report which level of the effort ladder found each code.
+         * A code found by several levels is reported once, by the cheapest level.
+         * @param image image used for datamatrix code detection and decoding
+         * @param options options for this call
+         * @return Decoded results that were found in the image
+         */
+        [[nodiscard]] std::vector<LeveledDecodeResult> decodeWithEffortLevels(const ImageView &image,
+                                                                              const DecodeOptions &options) const;
+        [[nodiscard]] std::vector<LeveledDecodeResult> decodeWithEffortLevels(const ImageView &image) const;
+
     private:
         std::unique_ptr<ZXingCodeReaderImpl> m_impl;
     };
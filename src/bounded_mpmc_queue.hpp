@@ -0,0 +1,100 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace sfdm::detail {
+    /*!
+     * Lock free multi producer multi consumer queue with a fixed capacity (Vyukov's bounded queue). Every cell carries
+     * a sequence number, that tells producers and consumers whether it is their turn. Pushing and popping never
+     * blocks and does not allocate.
+     * The sequence counts in half steps, 2 * position while the cell waits for the producer of position and
+     * 2 * position + 1 while it waits for the consumer. Unlike the original scheme, this also works with capacity 1.
+     */
+    template<typename T>
+    class BoundedMpmcQueue {
+    public:
+        explicit BoundedMpmcQueue(size_t capacity) : m_cells(capacity) {
+            if (capacity == 0) {
+                throw std::runtime_error{"Queue capacity must not be 0!"};
+            }
+            for (size_t i = 0; i < capacity; ++i) {
+                m_cells[i].sequence.store(2 * i, std::memory_order_relaxed);
+            }
+        }
+
+        /*!
+         * The item is only moved from, if it was pushed.
+         * @return false, if the queue is full
+         */
+        bool tryPush(T &item) {
+            auto position = m_enqueuePosition.load(std::memory_order_relaxed);
+            while (true) {
+                auto &cell = m_cells[position % m_cells.size()];
+                const auto sequence = cell.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(2 * position);
+                if (difference == 0) {
+                    if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        cell.value = std::move(item);
+                        cell.sequence.store(2 * position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (difference < 0) {
+                    return false;
+                } else {
+                    position = m_enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /*!
+         * @return Oldest item, or nothing if the queue is empty
+         */
+        std::optional<T> tryPop() {
+            auto position = m_dequeuePosition.load(std::memory_order_relaxed);
+            while (true) {
+                auto &cell = m_cells[position % m_cells.size()];
+                const auto sequence = cell.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(2 * position + 1);
+                if (difference == 0) {
+                    if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        std::optional<T> item{std::move(cell.value)};
+                        cell.sequence.store(2 * (position + m_cells.size()), std::memory_order_release);
+                        return item;
+                    }
+                } else if (difference < 0) {
+                    return std::nullopt;
+                } else {
+                    position = m_dequeuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /*!
+         * Number of items at the time of the call. Only a snapshot, while other threads push and pop.
+         */
+        [[nodiscard]] size_t size() const {
+            // the dequeue position is read first, so the difference cannot become negative
+            const auto dequeuePosition = m_dequeuePosition.load(std::memory_order_acquire);
+            const auto enqueuePosition = m_enqueuePosition.load(std::memory_order_acquire);
+            return std::min(enqueuePosition - dequeuePosition, m_cells.size());
+        }
+
+        [[nodiscard]] size_t capacity() const { return m_cells.size(); }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        std::vector<Cell> m_cells;
+        // on separate cache lines, so producers and consumers do not invalidate each other's positions
+        alignas(64) std::atomic<size_t> m_enqueuePosition{0};
+        alignas(64) std::atomic<size_t> m_dequeuePosition{0};
+    };
+} // namespace sfdm::detail
@@ -0,0 +1,65 @@
+#include <sfdm/code_location_prior.hpp>
+
+#include "code_position_utils.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sfdm {
+    CodeLocationPrior::CodeLocationPrior(size_t columns, size_t rows, double decay) :
+        m_columns{columns}, m_rows{rows}, m_decay{decay}, m_heat(columns * rows, 0.0) {
+        if (columns == 0 || rows == 0) {
+            throw std::runtime_error{"Code location prior needs at least one cell!"};
+        }
+        if (decay <= 0.0 || decay > 1.0) {
+            throw std::runtime_error{"Decay of the code location prior has to be in (0, 1]!"};
+        }
+    }
+
+    void CodeLocationPrior::observe(const ImageView &image, std::span<const CodePosition> positions) {
+        if (image.width == 0 || image.height == 0) {
+            return;
+        }
+        std::lock_guard lock(m_mutex);
+        for (auto &heat: m_heat) {
+            heat *= m_decay;
+        }
+        for (const auto &position: positions) {
+            const auto point = detail::center(position);
+            const auto column = std::min(m_columns - 1, point.x * m_columns / image.width);
+            const auto row = std::min(m_rows - 1, point.y * m_rows / image.height);
+            m_heat[row * m_columns + column] += 1.0;
+        }
+    }
+
+    std::vector<CodeLocationPrior::Cell> CodeLocationPrior::getHotCells(double minimumHeat) const {
+        std::vector<Cell> cells;
+        {
+            std::lock_guard lock(m_mutex);
+            for (size_t i = 0; i < m_heat.size(); ++i) {
+                if (m_heat[i] > 0.0 && m_heat[i] >= minimumHeat) {
+                    cells.push_back({i % m_columns, i / m_columns, m_heat[i]});
+                }
+            }
+        }
+        // stable, so cells of the same heat stay in row major order
+        std::ranges::stable_sort(cells, std::greater{}, &Cell::heat);
+        return cells;
+    }
+
+    double CodeLocationPrior::getHeat(size_t column, size_t row) const {
+        if (column >= m_columns || row >= m_rows) {
+            throw std::runtime_error{"Cell outside of the code location prior!"};
+        }
+        std::lock_guard lock(m_mutex);
+        return m_heat[row * m_columns + column];
+    }
+
+    size_t CodeLocationPrior::getColumns() const { return m_columns; }
+    size_t CodeLocationPrior::getRows() const { return m_rows; }
+
+    void CodeLocationPrior::reset() {
+        std::lock_guard lock(m_mutex);
+        std::ranges::fill(m_heat, 0.0);
+    }
+} // namespace sfdm
@@ -0,0 +1,86 @@
+#pragma once
+#include <algorithm>
+#include <sfdm/decode_result.hpp>
+#include <sfdm/image_view.hpp>
+
+namespace sfdm::detail {
+    struct Rectangle {
+        uint32_t left{};
+        uint32_t top{};
+        uint32_t right{};
+        uint32_t bottom{};
+
+        [[nodiscard]] uint32_t width() const { return right - left; }
+        [[nodiscard]] uint32_t height() const { return bottom - top; }
+    };
+
+    template<size_t distance = 5>
+    bool within5Pixels(const Point &p1, const Point &p2) {
+        const auto dx = p1.x - p2.x;
+        const auto dy = p1.y - p2.y;
+        return dx * dx + dy * dy <= distance * distance;
+    }
+
+    /*!
+     * Whether both positions describe the same code, even if the corners are labeled differently by the backends.
+     */
+    inline bool diagonallyOppositeMatch(const CodePosition &q1, const CodePosition &q2) {
+        if (within5Pixels(q1.bottomLeft, q2.bottomLeft) && within5Pixels(q1.topRight, q2.topRight)) {
+            return true;
+        }
+
+        return within5Pixels(q1.topLeft, q2.topLeft) && within5Pixels(q1.bottomRight, q2.bottomRight);
+    }
+
+    inline Point center(const CodePosition &position) {
+        return {(position.bottomLeft.x + position.topLeft.x + position.topRight.x + position.bottomRight.x) / 4,
+                (position.bottomLeft.y + position.topLeft.y + position.topRight.y + position.bottomRight.y) / 4};
+    }
+
+    /*!
+     * Bounding box of the position, right and bottom are exclusive.
+     */
+    inline Rectangle bounds(const CodePosition &position) {
+        const auto [minX, maxX] = std::minmax(
+                {position.bottomLeft.x, position.topLeft.x, position.topRight.x, position.bottomRight.x});
+        const auto [minY, maxY] = std::minmax(
+                {position.bottomLeft.y, position.topLeft.y, position.topRight.y, position.bottomRight.y});
+        return {minX, minY, maxX + 1, maxY + 1};
+    }
+
+    /*!
+     * Bounding box of the position, grown by margin on every side and clipped to the image.
+     * right and bottom are exclusive.
+     */
+    inline Rectangle boundingBox(const CodePosition &position, uint32_t margin, const ImageView &image) {
+        const auto [minX, maxX] = std::minmax(
+                {position.bottomLeft.x, position.topLeft.x, position.topRight.x, position.bottomRight.x});
+        const auto [minY, maxY] = std::minmax(
+                {position.bottomLeft.y, position.topLeft.y, position.topRight.y, position.bottomRight.y});
+        const auto clip = [](uint64_t value, size_t limit) {
+            return static_cast<uint32_t>(std::min<uint64_t>(value, limit));
+        };
+        return {minX > margin ? minX - margin : 0, minY > margin ? minY - margin : 0,
+                clip(uint64_t{maxX} + margin + 1, image.width), clip(uint64_t{maxY} + margin + 1, image.height)};
+    }
+
+    inline bool intersects(const Rectangle &r1, const Rectangle &r2) {
+        return r1.left < r2.right && r2.left < r1.right && r1.top < r2.bottom && r2.top < r1.bottom;
+    }
+
+    /*!
+     * Whether both results are the same code found in two overlapping strips. Codes cut by the strip border can get
+     * slightly different corners in both strips, so they are matched by text and overlapping bounds instead of corner
+     * distances.
+     */
+    inline bool isSameCode(const DecodeResult &r1, const DecodeResult &r2) {
+        return r1.text == r2.text && intersects(bounds(r1.position), bounds(r2.position));
+    }
+
+    inline Point translate(const Point &point, uint32_t dx, uint32_t dy) { return {point.x + dx, point.y + dy}; }
+
+    inline CodePosition translate(const CodePosition &position, uint32_t dx, uint32_t dy) {
+        return {translate(position.bottomLeft, dx, dy), translate(position.topLeft, dx, dy),
+                translate(position.topRight, dx, dy), translate(position.bottomRight, dx, dy)};
+    }
+} // namespace sfdm::detail
@@ -0,0 +1,7 @@
+#include <sfdm/composite_reader.hpp>
+
+#include "code_position_utils.hpp"
+
+namespace sfdm::detail {
+    bool isSamePosition(const CodePosition &p1, const CodePosition &p2) { return diagonallyOppositeMatch(p1, p2); }
+} // namespace sfdm::detail
@@ -0,0 +1,93 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <sfdm/decode_hints.hpp>
+#include <sfdm/decode_result.hpp>
+
+namespace sfdm::detail {
+    struct ModuleCountRange {
+        uint32_t min{};
+        uint32_t max{};
+    };
+
+    inline bool isSquare(const SymbolSize &size) { return size.rows == size.columns; }
+
+    /*!
+     * Range of the number of modules along one edge of the expected symbols.
+     */
+    inline ModuleCountRange moduleCountRange(const DecodeHints &hints) {
+        if (!hints.symbolSizes.empty()) {
+            ModuleCountRange range{UINT32_MAX, 0};
+            for (const auto &size: hints.symbolSizes) {
+                range.min = std::min({range.min, size.rows, size.columns});
+                range.max = std::max({range.max, size.rows, size.columns});
+            }
+            return range;
+        }
+        switch (hints.shape) {
+            case SymbolShape::Square:
+                return {10, 144};
+            case SymbolShape::Rectangle:
+                return {8, 48};
+            case SymbolShape::Any:
+                break;
+        }
+        return {8, 144};
+    }
+
+    struct EdgeLengthRange {
+        std::optional<uint32_t> min;
+        std::optional<uint32_t> max;
+    };
+
+    /*!
+     * Range of the expected edge length of a symbol in pixels, derived from the module size hints.
+     */
+    inline EdgeLengthRange edgeLengthRange(const DecodeHints &hints) {
+        const auto moduleCounts = moduleCountRange(hints);
+        EdgeLengthRange range;
+        if (hints.minModuleSize) {
+            range.min = *hints.minModuleSize * moduleCounts.min;
+        }
+        if (hints.maxModuleSize) {
+            range.max = *hints.maxModuleSize * moduleCounts.max;
+        }
+        return range;
+    }
+
+    inline double distance(const Point &p1, const Point &p2) {
+        const auto dx = static_cast<double>(p1.x) - static_cast<double>(p2.x);
+        const auto dy = static_cast<double>(p1.y) - static_cast<double>(p2.y);
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    /*!
+     * Whether the position can belong to a symbol described by the hints. Used for backends, that cannot restrict
+     * their search. Edge lengths get 10% slack for perspective distortion.
+     */
+    inline bool matchesHints(const CodePosition &position, const DecodeHints &hints) {
+        const auto height = distance(position.bottomLeft, position.topLeft);
+        const auto width = distance(position.bottomLeft, position.bottomRight);
+        const auto [shortEdge, longEdge] = std::minmax(width, height);
+
+        auto shape = hints.shape;
+        if (!hints.symbolSizes.empty()) {
+            const bool allSquare = std::ranges::all_of(hints.symbolSizes, isSquare);
+            const bool noneSquare = std::ranges::none_of(hints.symbolSizes, isSquare);
+            shape = allSquare ? SymbolShape::Square : noneSquare ? SymbolShape::Rectangle : shape;
+        }
+        // the flattest square symbol is still closer to 1:1 than the least elongated rectangle (12x26)
+        constexpr double rectangleAspectRatio = 1.5;
+        const bool isRectangle = longEdge > rectangleAspectRatio * shortEdge;
+        if ((shape == SymbolShape::Square && isRectangle) || (shape == SymbolShape::Rectangle && !isRectangle)) {
+            return false;
+        }
+
+        const auto edgeLengths = edgeLengthRange(hints);
+        if (edgeLengths.min && shortEdge < 0.9 * *edgeLengths.min) {
+            return false;
+        }
+        return !edgeLengths.max || longEdge <= 1.1 * *edgeLengths.max;
+    }
+} // namespace sfdm::detail
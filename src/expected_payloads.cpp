@@ -0,0 +1,28 @@
+#include <sfdm/expected_payloads.hpp>
+
+namespace sfdm {
+    ExpectedPayloads::ExpectedPayloads(std::vector<std::string> texts) {
+        m_items.reserve(texts.size());
+        for (auto &text: texts) {
+            addText(std::move(text));
+        }
+    }
+
+    void ExpectedPayloads::addText(std::string text) { m_items.push_back({std::move(text), std::nullopt}); }
+
+    void ExpectedPayloads::addPattern(const std::string &pattern) {
+        // regex_error is a runtime_error, so invalid patterns are reported like all other errors
+        m_items.push_back({pattern, std::regex{pattern, std::regex::ECMAScript | std::regex::optimize}});
+    }
+
+    size_t ExpectedPayloads::size() const { return m_items.size(); }
+    bool ExpectedPayloads::empty() const { return m_items.empty(); }
+
+    bool ExpectedPayloads::matches(size_t index, std::string_view text) const {
+        const auto &item = m_items[index];
+        if (item.pattern) {
+            return std::regex_match(text.begin(), text.end(), *item.pattern);
+        }
+        return item.text == text;
+    }
+} // namespace sfdm
@@ -0,0 +1,111 @@
+#include <sfdm/decode_options.hpp>
+#include <sfdm/image_quality.hpp>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace {
+    uint8_t percentile(const std::array<uint64_t, 256> &histogram, uint64_t sampleCount, double fraction) {
+        const auto target = static_cast<uint64_t>(fraction * static_cast<double>(sampleCount));
+        uint64_t count = 0;
+        for (size_t value = 0; value < histogram.size(); ++value) {
+            count += histogram[value];
+            if (count > target) {
+                return static_cast<uint8_t>(value);
+            }
+        }
+        return 255;
+    }
+} // namespace
+
+namespace sfdm {
+    ImageQuality measureImageQuality(const ImageView &image, size_t sampleStep) {
+        if (sampleStep == 0) {
+            throw std::runtime_error{"Sample step must not be 0!"};
+        }
+        if (image.width < 3 || image.height < 3) {
+            return {};
+        }
+
+        std::array<uint64_t, 256> histogram{};
+        int64_t laplacianSum = 0;
+        int64_t laplacianSquareSum = 0;
+        uint64_t sampleCount = 0;
+
+        // the border is skipped, so every sample has all four neighbours
+        for (size_t y = 1; y + 1 < image.height; y += sampleStep) {
+            const uint8_t *above = image.data + (y - 1) * image.width;
+            const uint8_t *row = above + image.width;
+            const uint8_t *below = row + image.width;
+            for (size_t x = 1; x + 1 < image.width; x += sampleStep) {
+                const int32_t center = row[x];
+                const int32_t laplacian = 4 * center - row[x - 1] - row[x + 1] - above[x] - below[x];
+                laplacianSum += laplacian;
+                laplacianSquareSum += laplacian * laplacian;
+                ++histogram[center];
+                ++sampleCount;
+            }
+        }
+
+        const auto count = static_cast<double>(sampleCount);
+        const auto laplacianMean = static_cast<double>(laplacianSum) / count;
+
+        ImageQuality quality;
+        quality.sharpness = static_cast<double>(laplacianSquareSum) / count - laplacianMean * laplacianMean;
+
+        uint64_t brightnessSum = 0;
+        for (size_t value = 0; value < histogram.size(); ++value) {
+            brightnessSum += value * histogram[value];
+        }
+        quality.brightness = static_cast<double>(brightnessSum) / count;
+        quality.contrast = percentile(histogram, sampleCount, 0.95) - percentile(histogram, sampleCount, 0.05);
+
+        uint64_t overexposed = 0;
+        for (size_t value = 250; value < histogram.size(); ++value) {
+            overexposed += histogram[value];
+        }
+        uint64_t underexposed = 0;
+        for (size_t value = 0; value <= 5; ++value) {
+            underexposed += histogram[value];
+        }
+        quality.overexposedFraction = static_cast<double>(overexposed) / count;
+        quality.underexposedFraction = static_cast<double>(underexposed) / count;
+        return quality;
+    }
+
+    QualityAction evaluateQualityGate(const ImageQuality &quality, const QualityGate &gate) {
+        const bool passes = quality.sharpness >= gate.minSharpness && quality.contrast >= gate.minContrast &&
+                            quality.overexposedFraction <= gate.maxOverexposedFraction &&
+                            quality.underexposedFraction <= gate.maxUnderexposedFraction;
+        return passes ? QualityAction::Decode : gate.onFailure;
+    }
+
+    std::optional<DecodeOptions> applyQualityGate(const ImageView &image, const DecodeOptions &options,
+                                                  DecodeReport &report) {
+        auto gatedOptions = options;
+        gatedOptions.qualityGate.reset();
+        if (!options.qualityGate) {
+            return gatedOptions;
+        }
+
+        const auto &gate = *options.qualityGate;
+        report.quality = measureImageQuality(image, gate.sampleStep);
+        report.qualityAction = evaluateQualityGate(*report.quality, gate);
+        switch (report.qualityAction) {
+            case QualityAction::Decode:
+                return gatedOptions;
+            case QualityAction::Downgrade:
+                gatedOptions.timeoutMSec = gatedOptions.timeoutMSec
+                                                   ? std::min(gatedOptions.timeoutMSec, gate.downgradedTimeoutMSec)
+                                                   : gate.downgradedTimeoutMSec;
+                gatedOptions.maximumEffortLevels =
+                        std::min(gatedOptions.maximumEffortLevels.value_or(gate.downgradedEffortLevels),
+                                 gate.downgradedEffortLevels);
+                return gatedOptions;
+            case QualityAction::Reject:
+                break;
+        }
+        return std::nullopt;
+    }
+} // namespace sfdm
@@ -1,28 +1,91 @@
 #include <dmtx.h>
+#include <sfdm/code_location_prior.hpp>
 #include <sfdm/libdmtx_code_reader.hpp>
 
+#include "code_position_utils.hpp"
+#include "decode_hints_utils.hpp"
+#include "memory_plan.hpp"
+#include "quality_gate_utils.hpp"
+#include "stop_condition.hpp"
+
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <span>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <thread>
 
 namespace {
+    struct SymbolSizeMapping {
+        sfdm::SymbolSize size;
+        DmtxSymbolSize dmtxSize;
+    };
+
+    constexpr std::array symbolSizeMappings{
+            SymbolSizeMapping{{10, 10}, DmtxSymbol10x10},     SymbolSizeMapping{{12, 12}, DmtxSymbol12x12},
+            SymbolSizeMapping{{14, 14}, DmtxSymbol14x14},     SymbolSizeMapping{{16, 16}, DmtxSymbol16x16},
+            SymbolSizeMapping{{18, 18}, DmtxSymbol18x18},     SymbolSizeMapping{{20, 20}, DmtxSymbol20x20},
+            SymbolSizeMapping{{22, 22}, DmtxSymbol22x22},     SymbolSizeMapping{{24, 24}, DmtxSymbol24x24},
+            SymbolSizeMapping{{26, 26}, DmtxSymbol26x26},     SymbolSizeMapping{{32, 32}, DmtxSymbol32x32},
+            SymbolSizeMapping{{36, 36}, DmtxSymbol36x36},     SymbolSizeMapping{{40, 40}, DmtxSymbol40x40},
+            SymbolSizeMapping{{44, 44}, DmtxSymbol44x44},     SymbolSizeMapping{{48, 48}, DmtxSymbol48x48},
+            SymbolSizeMapping{{52, 52}, DmtxSymbol52x52},     SymbolSizeMapping{{64, 64}, DmtxSymbol64x64},
+            SymbolSizeMapping{{72, 72}, DmtxSymbol72x72},     SymbolSizeMapping{{80, 80}, DmtxSymbol80x80},
+            SymbolSizeMapping{{88, 88}, DmtxSymbol88x88},     SymbolSizeMapping{{96, 96}, DmtxSymbol96x96},
+            SymbolSizeMapping{{104, 104}, DmtxSymbol104x104}, SymbolSizeMapping{{120, 120}, DmtxSymbol120x120},
+            SymbolSizeMapping{{132, 132}, DmtxSymbol132x132}, SymbolSizeMapping{{144, 144}, DmtxSymbol144x144},
+            SymbolSizeMapping{{8, 18}, DmtxSymbol8x18},       SymbolSizeMapping{{8, 32}, DmtxSymbol8x32},
+            SymbolSizeMapping{{12, 26}, DmtxSymbol12x26},     SymbolSizeMapping{{12, 36}, DmtxSymbol12x36},
+            SymbolSizeMapping{{16, 36}, DmtxSymbol16x36},     SymbolSizeMapping{{16, 48}, DmtxSymbol16x48},
+    };
+
+    DmtxSymbolSize toDmtxSymbolSize(const sfdm::SymbolSize &size) {
+        const auto it = std::ranges::find(symbolSizeMappings, size, &SymbolSizeMapping::size);
+        if (it == symbolSizeMappings.end()) {
+            throw std::runtime_error{"Unsupported symbol size " + std::to_string(size.rows) + "x" +
+                                     std::to_string(size.columns) + "!"};
+        }
+        return it->dmtxSize;
+    }
+
+    DmtxSymbolSize toDmtxSymbolSize(const sfdm::DecodeHints &hints) {
+        if (hints.symbolSizes.size() == 1) {
+            return toDmtxSymbolSize(hints.symbolSizes.front());
+        }
+        auto shape = hints.shape;
+        if (!hints.symbolSizes.empty()) {
+            if (std::ranges::all_of(hints.symbolSizes, sfdm::detail::isSquare)) {
+                shape = sfdm::SymbolShape::Square;
+            } else if (std::ranges::none_of(hints.symbolSizes, sfdm::detail::isSquare)) {
+                shape = sfdm::SymbolShape::Rectangle;
+            }
+        }
+        switch (shape) {
+            case sfdm::SymbolShape::Square:
+                return DmtxSymbolSquareAuto;
+            case sfdm::SymbolShape::Rectangle:
+                return DmtxSymbolRectAuto;
+            case sfdm::SymbolShape::Any:
+                break;
+        }
+        return DmtxSymbolShapeAuto;
+    }
+
+    void setProperty(DmtxDecode *decoder, DmtxProperty property, int value) {
+        if (dmtxDecodeSetProp(decoder, property, value) != DmtxPass) {
+            throw std::runtime_error{"Invalid decode hint value " + std::to_string(value) + "!"};
+        }
+    }
+
+    // unique_ptr instead of shared_ptr, so no control blocks are allocated for each decode
     class DecodeGuard {
     public:
-        explicit DecodeGuard(const sfdm::ImageView &image) :
+        DecodeGuard(const sfdm::ImageView &image, const sfdm::DecodeHints &hints) :
             m_image(dmtxImageCreate(image.data, static_cast<int>(image.width), static_cast<int>(image.height),
-                                    DmtxPack8bppK),
-                    [](DmtxImage *dmtxImage) {
-                        if (dmtxImage) {
-                            dmtxImageDestroy(&dmtxImage);
-                        }
-                    }),
-            m_decoder(dmtxDecodeCreate(m_image.get(), 1), [](DmtxDecode *decoder) {
-                if (decoder) {
-                    dmtxDecodeDestroy(&decoder);
-                }
-            }) {
+                                    DmtxPack8bppK)),
+            m_decoder(dmtxDecodeCreate(m_image.get(), 1)) {
             if (!m_image) {
                 throw std::runtime_error("Could not create image!");
             }
@@ -30,20 +93,115 @@ namespace {
             if (!m_decoder) {
                 throw std::runtime_error("Could not create decoder!");
             }
+            applyHints(hints);
         }
 
-        std::shared_ptr<DmtxDecode> getDecoder() { return m_decoder; }
+        DmtxDecode *getDecoder() { return m_decoder.get(); }
+
+        /*!
+         * Restricts the scan to the rectangle, given in image coordinates. libdmtx counts rows from the bottom.
+         */
+        void restrictTo(const sfdm::detail::Rectangle &rectangle, size_t imageHeight) {
+            auto *decoder = m_decoder.get();
+            setProperty(decoder, DmtxPropXmin, static_cast<int>(rectangle.left));
+            setProperty(decoder, DmtxPropXmax, static_cast<int>(rectangle.right - 1));
+            setProperty(decoder, DmtxPropYmin, static_cast<int>(imageHeight - rectangle.bottom));
+            setProperty(decoder, DmtxPropYmax, static_cast<int>(imageHeight - 1 - rectangle.top));
+        }
 
     private:
-        std::shared_ptr<DmtxImage> m_image;
-        std::shared_ptr<DmtxDecode> m_decoder;
+        void applyHints(const sfdm::DecodeHints &hints) {
+            auto *decoder = m_decoder.get();
+            setProperty(decoder, DmtxPropSymbolSize, toDmtxSymbolSize(hints));
+
+            const auto edgeLengths = sfdm::detail::edgeLengthRange(hints);
+            if (edgeLengths.min) {
+                setProperty(decoder, DmtxPropEdgeMin, static_cast<int>(*edgeLengths.min));
+            }
+            if (edgeLengths.max) {
+                setProperty(decoder, DmtxPropEdgeMax, static_cast<int>(*edgeLengths.max));
+            }
+            if (hints.edgeThreshold) {
+                setProperty(decoder, DmtxPropEdgeThresh, static_cast<int>(*hints.edgeThreshold));
+            }
+            if (hints.squareDeviation) {
+                setProperty(decoder, DmtxPropSquareDevn, static_cast<int>(*hints.squareDeviation));
+            }
+            if (hints.scanGap) {
+                setProperty(decoder, DmtxPropScanGap, static_cast<int>(*hints.scanGap));
+            }
+        }
+
+        struct ImageDeleter {
+            void operator()(DmtxImage *dmtxImage) const {
+                if (dmtxImage) {
+                    dmtxImageDestroy(&dmtxImage);
+                }
+            }
+        };
+        struct DecoderDeleter {
+            void operator()(DmtxDecode *decoder) const {
+                if (decoder) {
+                    dmtxDecodeDestroy(&decoder);
+                }
+            }
+        };
+
+        std::unique_ptr<DmtxImage, ImageDeleter> m_image;
+        std::unique_ptr<DmtxDecode, DecoderDeleter> m_decoder;
     };
 
+    // region searches, that can be stopped, are split into slices of this length. The stop token is checked in between.
+    constexpr int64_t stopCheckIntervalMSec = 2;
+
+    // the decode cache, the image is not copied
+    constexpr double libdmtxBytesPerPixel = 1.0;
+
+    // hot areas searched before the whole image. Codes outside of them cost at most one more timeout.
+    constexpr size_t maximumHotAreas = 4;
+
     uint32_t invertYAxis(size_t imageHeight, uint32_t value) { return static_cast<uint32_t>(imageHeight - 1 - value); }
 
     uint32_t roundToNearest(double value) { return static_cast<uint32_t>(value + 0.5); }
 
-    sfdm::CodePosition getPosition(const sfdm::ImageView &image, const std::shared_ptr<DmtxRegion> &region) {
+    struct LibdmtxDetectionState : sfdm::detail::DetectionState {
+        explicit LibdmtxDetectionState(const DmtxRegion &region) : region{region} {}
+        DmtxRegion region;
+    };
+
+    // dmtxDecodeMatrixRegion marks decoded regions in the cache, so the scan does not find them again. Detection does
+    // not decode, so the pixels inside the region are marked here the same way.
+    void markVisited(DmtxDecode *decoder, DmtxRegion &region) {
+        const int width = dmtxDecodeGetProp(decoder, DmtxPropWidth);
+        const int height = dmtxDecodeGetProp(decoder, DmtxPropHeight);
+
+        double minX = width;
+        double maxX = 0;
+        double minY = height;
+        double maxY = 0;
+        for (DmtxVector2 corner: {DmtxVector2{0, 0}, DmtxVector2{0, 1}, DmtxVector2{1, 0}, DmtxVector2{1, 1}}) {
+            dmtxMatrix3VMultiplyBy(&corner, region.fit2raw);
+            minX = std::min(minX, corner.X);
+            maxX = std::max(maxX, corner.X);
+            minY = std::min(minY, corner.Y);
+            maxY = std::max(maxY, corner.Y);
+        }
+
+        for (int y = std::max(0, static_cast<int>(minY)); y <= std::min(height - 1, static_cast<int>(maxY)); ++y) {
+            for (int x = std::max(0, static_cast<int>(minX)); x <= std::min(width - 1, static_cast<int>(maxX)); ++x) {
+                DmtxVector2 point{static_cast<double>(x), static_cast<double>(y)};
+                dmtxMatrix3VMultiplyBy(&point, region.raw2fit);
+                if (point.X < 0.0 || point.X > 1.0 || point.Y < 0.0 || point.Y > 1.0) {
+                    continue;
+                }
+                if (auto *cache = dmtxDecodeGetCache(decoder, x, y)) {
+                    *cache |= 0x80;
+                }
+            }
+        }
+    }
+
+    sfdm::CodePosition getPosition(const sfdm::ImageView &image, DmtxRegion *region) {
         DmtxVector2 bottomLeft{0, 0};
         DmtxVector2 topLeft{0, 1};
         DmtxVector2 bottomRight{1, 0};
@@ -59,52 +217,213 @@ namespace {
                 sfdm::Point{roundToNearest(topRight.X), invertYAxis(image.height, roundToNearest(topRight.Y))},
                 sfdm::Point{roundToNearest(bottomRight.X), invertYAxis(image.height, roundToNearest(bottomRight.Y))}};
     }
+
+    /*!
+     * Surroundings of the hottest cells of the prior, hottest first. A code, whose center lies in a cell, lies inside
+     * its area, if the code is smaller than the margin: the maximum edge length of the hints, or one cell.
+     */
+    std::vector<sfdm::detail::Rectangle> hotSearchAreas(const sfdm::ImageView &image,
+                                                        const sfdm::DecodeOptions &options) {
+        const auto &prior = *options.locationPrior;
+        const auto columns = prior.getColumns();
+        const auto rows = prior.getRows();
+        const auto maxEdgeLength = sfdm::detail::edgeLengthRange(options.hints).max;
+        const size_t margin = maxEdgeLength ? *maxEdgeLength : std::max(image.width / columns, image.height / rows);
+
+        std::vector<sfdm::detail::Rectangle> areas;
+        for (const auto &cell: prior.getHotCells()) {
+            const size_t left = cell.column * image.width / columns;
+            const size_t top = cell.row * image.height / rows;
+            const size_t right = (cell.column + 1) * image.width / columns;
+            const size_t bottom = (cell.row + 1) * image.height / rows;
+            const sfdm::detail::Rectangle area{static_cast<uint32_t>(left > margin ? left - margin : 0),
+                                               static_cast<uint32_t>(top > margin ? top - margin : 0),
+                                               static_cast<uint32_t>(std::min(right + margin, image.width)),
+                                               static_cast<uint32_t>(std::min(bottom + margin, image.height))};
+            if (area.width() == image.width && area.height() == image.height) {
+                // the whole image is scanned last anyway
+                break;
+            }
+            if (area.width() >= 2 && area.height() >= 2) {
+                areas.push_back(area);
+            }
+            if (areas.size() == maximumHotAreas) {
+                break;
+            }
+        }
+        return areas;
+    }
+
+    // feeds the codes of a frame into the prior once the scan ends, also if the consumer stops reading early
+    class FrameObservation {
+    public:
+        FrameObservation(sfdm::CodeLocationPrior *prior, const sfdm::ImageView &image) :
+            m_prior{prior}, m_image{image} {}
+        ~FrameObservation() {
+            if (m_prior) {
+                m_prior->observe(m_image, m_positions);
+            }
+        }
+        FrameObservation(const FrameObservation &) = delete;
+        FrameObservation &operator=(const FrameObservation &) = delete;
+
+        void add(const sfdm::CodePosition &position) {
+            if (m_prior) {
+                m_positions.push_back(position);
+            }
+        }
+
+        [[nodiscard]] bool contains(const sfdm::CodePosition &position) const {
+            return std::ranges::any_of(m_positions, [&](const sfdm::CodePosition &found) {
+                return sfdm::detail::diagonallyOppositeMatch(found, position);
+            });
+        }
+
+    private:
+        sfdm::CodeLocationPrior *m_prior;
+        sfdm::ImageView m_image;
+        std::vector<sfdm::CodePosition> m_positions;
+    };
 } // namespace
 
 namespace sfdm {
-    std::pair<std::shared_ptr<DmtxRegion>, LibdmtxCodeReader::StopCause>
-    LibdmtxCodeReader::detectNext(const std::shared_ptr<DmtxDecode> &decoder) const {
-        DmtxScanConstraint constraint{};
-
-        DmtxTime timeout = dmtxTimeNow();
-        timeout = dmtxTimeAdd(timeout, m_timeoutMSec);
-        constraint.maxTimeout = &timeout;
-
-        std::shared_ptr<DmtxRegion> region{
-                dmtxRegionFindNextDeterministic(decoder.get(), m_timeoutMSec ? &constraint : nullptr),
-                [](DmtxRegion *region) {
-                    if (region) {
-                        dmtxRegionDestroy(&region);
-                    }
-                }};
-        return {region, static_cast<LibdmtxCodeReader::StopCause>(constraint.stopCause)};
-    }
-
-    [[nodiscard]] std::shared_ptr<DmtxMessage_struct>
-    LibdmtxCodeReader::decode(const std::shared_ptr<DmtxDecode_struct> &decoder,
-                              const std::shared_ptr<DmtxRegion_struct> &region) const {
-        return {dmtxDecodeMatrixRegion(decoder.get(), region.get(), DmtxTrue), [](auto *message) {
-                    if (message) {
-                        dmtxMessageDestroy(&message);
-                    }
-                }};
-    }
-
-    std::vector<DecodeResult> LibdmtxCodeReader::decode(const ImageView &image) const { return decode(image, {}); }
-    std::vector<DecodeResult> LibdmtxCodeReader::decode(const ImageView &image,
+    void LibdmtxCodeReader::RegionDeleter::operator()(DmtxRegion *region) const {
+        if (region) {
+            dmtxRegionDestroy(&region);
+        }
+    }
+
+    void LibdmtxCodeReader::MessageDeleter::operator()(DmtxMessage *message) const {
+        if (message) {
+            dmtxMessageDestroy(&message);
+        }
+    }
+
+    std::pair<LibdmtxCodeReader::RegionPtr, LibdmtxCodeReader::StopCause>
+    LibdmtxCodeReader::detectNext(DmtxDecode *decoder, const DecodeOptions &options) const {
+        if (options.stopToken.stop_requested()) {
+            return {nullptr, StopCause::ScanTimeLimit};
+        }
+        int64_t timeoutMSec = options.timeoutMSec;
+        if (options.deadline) {
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                           *options.deadline - std::chrono::steady_clock::now())
+                                           .count();
+            if (remaining <= 0) {
+                return {nullptr, StopCause::ScanTimeLimit};
+            }
+            timeoutMSec = timeoutMSec ? std::min(timeoutMSec, remaining) : remaining;
+        }
+
+        if (!options.stopToken.stop_possible()) {
+            DmtxScanConstraint constraint{};
+
+            DmtxTime timeout = dmtxTimeNow();
+            timeout = dmtxTimeAdd(timeout, static_cast<long>(timeoutMSec));
+            constraint.maxTimeout = &timeout;
+
+            RegionPtr region{dmtxRegionFindNextDeterministic(decoder, timeoutMSec ? &constraint : nullptr)};
+            return {std::move(region), static_cast<LibdmtxCodeReader::StopCause>(constraint.stopCause)};
+        }
+
+        // the scan position is kept in the decoder, so a search that ran out of its slice continues where it stopped
+        const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds{timeoutMSec};
+        while (true) {
+            int64_t sliceMSec = stopCheckIntervalMSec;
+            if (timeoutMSec) {
+                const auto remaining =
+                        std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now())
+                                .count();
+                if (remaining <= 0) {
+                    return {nullptr, StopCause::ScanTimeLimit};
+                }
+                sliceMSec = std::min(sliceMSec, remaining);
+            }
+
+            DmtxScanConstraint constraint{};
+            DmtxTime timeout = dmtxTimeAdd(dmtxTimeNow(), static_cast<long>(sliceMSec));
+            constraint.maxTimeout = &timeout;
+
+            RegionPtr region{dmtxRegionFindNextDeterministic(decoder, &constraint)};
+            const auto stopCause = static_cast<LibdmtxCodeReader::StopCause>(constraint.stopCause);
+            if (region || stopCause != StopCause::ScanTimeLimit || options.stopToken.stop_requested()) {
+                return {std::move(region), stopCause};
+            }
+        }
+    }
+
+    LibdmtxCodeReader::MessagePtr LibdmtxCodeReader::decode(DmtxDecode *decoder, DmtxRegion *region) const {
+        return MessagePtr{dmtxDecodeMatrixRegion(decoder, region, DmtxTrue)};
+    }
+
+    std::pair<LibdmtxCodeReader::MessagePtr, LibdmtxCodeReader::RegionPtr>
+    LibdmtxCodeReader::decodeNext(DmtxDecode *decoder, const DecodeOptions &options) const {
+        while (true) {
+            auto [region, stopCause] = detectNext(decoder, options);
+            // stopCause can be NotFound, but a valid region is returned, which may actually contain a valid code.
+            if (!region && stopCause != StopCause::ScanSuccess) {
+                return {};
+            }
+
+            auto message = decode(decoder, region.get());
+            if (message) {
+                return {std::move(message), std::move(region)};
+            }
+        }
+    }
+
+    std::vector<DecodeResult> LibdmtxCodeReader::decode(const ImageView &image, const DecodeOptions &options) const {
+        return decode(image, options, {});
+    }
+    std::vector<DecodeResult> LibdmtxCodeReader::decode(const ImageView &image, const DecodeOptions &options,
                                                         std::function<void(DecodeResult)> callback) const {
+        if (options.qualityGate) {
+            return detail::withQualityGate(image, options, [&](const DecodeOptions &gatedOptions) {
+                return decode(image, gatedOptions, std::move(callback));
+            });
+        }
+
+        bool inlineCallbacks = false;
+        if (options.memoryLimit) {
+            const auto layout = detail::planScan(image, options, libdmtxBytesPerPixel);
+            if (!layout) {
+                return {};
+            }
+            if (!layout->isOriginal(image)) {
+                // codes in the overlap of two strips are only known to be duplicates after both strips were decoded
+                auto results = detail::decodeInLayout(image, options, *layout,
+                                                      [&](const ImageView &strip, const DecodeOptions &stripOptions) {
+                                                          return decode(strip, stripOptions);
+                                                      });
+                FrameObservation observation(options.locationPrior.get(), image);
+                for (const auto &result: results) {
+                    observation.add(result.position);
+                }
+                if (callback) {
+                    std::ranges::for_each(results, callback);
+                }
+                return results;
+            }
+            // every callback runs on its own thread, at most one per code
+            const auto threadBytes =
+                    std::min<size_t>(options.maximumNumberOfCodesToDetect, 255) * detail::callbackThreadBytes;
+            inlineCallbacks = layout->workingBytes + threadBytes > *options.memoryLimit;
+        }
+
         std::vector<DecodeResult> results;
-        results.reserve(m_maximumNumberOfCodesToDetect);
+        results.reserve(options.maximumNumberOfCodesToDetect);
         std::vector<std::jthread> threads;
-        if (callback) {
-            threads.reserve(m_maximumNumberOfCodesToDetect);
+        if (callback && !inlineCallbacks) {
+            threads.reserve(options.maximumNumberOfCodesToDetect);
         }
 
-        auto stream = decodeStream(image);
+        auto stream = decodeStream(image, options);
 
         while (stream.next()) {
-            const auto decodeResult = stream.value();
-            if (callback) {
+            const auto &decodeResult = stream.value();
+            if (callback && inlineCallbacks) {
+                callback(decodeResult);
+            } else if (callback) {
                 threads.emplace_back(callback, decodeResult);
             }
             results.emplace_back(decodeResult);
@@ -115,36 +434,181 @@ namespace sfdm {
         return results;
     }
 
+    void LibdmtxCodeReader::decode(const ImageView &image, const DecodeOptions &options,
+                                   DecodeResultBuffer &results) const {
+        if (options.qualityGate) {
+            results.clear();
+            detail::withQualityGate(image, options,
+                                    [&](const DecodeOptions &gatedOptions) { decode(image, gatedOptions, results); });
+            return;
+        }
+        if (options.memoryLimit || options.locationPrior) {
+            // strips, downscaled copies and hot areas are merged by decode, the buffer receives a copy of its results
+            results.clear();
+            for (const auto &result: decode(image, options)) {
+                results.push(result.text, result.position);
+            }
+            return;
+        }
+        results.clear();
+        DecodeGuard decodeGuard(image, options.hints);
+
+        detail::StopCondition stopCondition(options);
+        while (!stopCondition.isReached()) {
+            const auto [message, region] = decodeNext(decodeGuard.getDecoder(), options);
+            if (!message) {
+                return;
+            }
+            const std::string_view text = reinterpret_cast<const char *>(message->output);
+            results.push(text, getPosition(image, region.get()));
+            stopCondition.add(text);
+        }
+    }
+
+    std::vector<DetectionResult> LibdmtxCodeReader::detect(const ImageView &image, const DecodeOptions &options) const {
+        if (options.qualityGate) {
+            return detail::withQualityGate(image, options, [&](const DecodeOptions &gatedOptions) {
+                return detect(image, gatedOptions);
+            });
+        }
+
+        std::vector<DetectionResult> detections;
+        DecodeGuard decodeGuard(image, options.hints);
+        auto *decoder = decodeGuard.getDecoder();
+        while (detections.size() < options.maximumNumberOfCodesToDetect) {
+            const auto [region, stopCause] = detectNext(decoder, options);
+            if (!region) {
+                if (stopCause != StopCause::ScanSuccess) {
+                    break;
+                }
+                continue;
+            }
+            markVisited(decoder, *region);
+            detections.push_back({getPosition(image, region.get()), std::make_shared<LibdmtxDetectionState>(*region)});
+        }
+        return detections;
+    }
+
+    std::optional<DecodeResult> LibdmtxCodeReader::decode(const ImageView &image, const DetectionResult &detection,
+                                                          const DecodeOptions &options) const {
+        DecodeGuard decodeGuard(image, options.hints);
+        if (const auto *state = dynamic_cast<const LibdmtxDetectionState *>(detection.state.get())) {
+            // dmtxDecodeMatrixRegion takes a mutable region, the detection may be decoded by several threads
+            auto region = state->region;
+            const auto message = decode(decodeGuard.getDecoder(), &region);
+            if (!message) {
+                return std::nullopt;
+            }
+            return DecodeResult{reinterpret_cast<const char *>(message->output), getPosition(image, &region)};
+        }
+
+        const auto bounds = detail::bounds(detection.position);
+        const auto searchArea =
+                detail::boundingBox(detection.position, std::max(bounds.width(), bounds.height()) / 2, image);
+        if (searchArea.width() < 2 || searchArea.height() < 2) {
+            return std::nullopt;
+        }
+        decodeGuard.restrictTo(searchArea, image.height);
+        const auto [message, region] = decodeNext(decodeGuard.getDecoder(), options);
+        if (!message) {
+            return std::nullopt;
+        }
+        return DecodeResult{reinterpret_cast<const char *>(message->output), getPosition(image, region.get())};
+    }
+
     ResultStream LibdmtxCodeReader::decodeStream(const ImageView &image) const {
-        DecodeGuard decodeGuard(image);
+        return decodeStream(image, m_defaultOptions);
+    }
 
-        size_t detectedCodes = 0;
-        while (detectedCodes < m_maximumNumberOfCodesToDetect) {
-            const auto [region, stopCause] = detectNext(decodeGuard.getDecoder());
-            // stopCause can be NotFound, but a valid region is returned, which may actually contain a valid code.
-            if (!region && stopCause != StopCause::ScanSuccess) {
+    // options are taken by value, the coroutine frame outlives the caller's arguments
+    ResultStream LibdmtxCodeReader::decodeStream(const ImageView &image, DecodeOptions options) const {
+        if (options.memoryLimit) {
+            const auto layout = detail::planScan(image, options, libdmtxBytesPerPixel);
+            if (!layout) {
                 co_return;
             }
+            if (!layout->isOriginal(image)) {
+                for (auto &result: decode(image, options)) {
+                    co_yield std::move(result);
+                }
+                co_return;
+            }
+        }
+        DecodeGuard decodeGuard(image, options.hints);
+        FrameObservation observation(options.locationPrior.get(), image);
+        const auto hotAreas =
+                options.locationPrior ? hotSearchAreas(image, options) : std::vector<detail::Rectangle>{};
+        const detail::Rectangle wholeImage{0, 0, static_cast<uint32_t>(image.width),
+                                           static_cast<uint32_t>(image.height)};
 
-            const auto message = decode(decodeGuard.getDecoder(), region);
-            if (!message) {
-                continue;
+        // the hot areas share one timeout, that is reset after each code like the timeout of the whole image
+        auto hotAreaOptions = options;
+        const auto startHotAreaTimeout = [&] {
+            if (options.timeoutMSec) {
+                const auto deadline =
+                        std::chrono::steady_clock::now() + std::chrono::milliseconds{options.timeoutMSec};
+                hotAreaOptions.deadline = options.deadline ? std::min(*options.deadline, deadline) : deadline;
             }
-            const CodePosition position = getPosition(image, region);
-            DecodeResult decodeResult{reinterpret_cast<const char *>(message->output), position};
+        };
+        startHotAreaTimeout();
 
-            ++detectedCodes;
-            co_yield decodeResult;
+        // the hot areas first, then the whole image. Setting the bounds restarts the scan, regions decoded before stay
+        // marked in the cache, so they are not decoded again.
+        detail::StopCondition stopCondition(options);
+        for (size_t area = 0; area <= hotAreas.size() && !stopCondition.isReached(); ++area) {
+            if (!hotAreas.empty()) {
+                decodeGuard.restrictTo(area < hotAreas.size() ? hotAreas[area] : wholeImage, image.height);
+            }
+            const auto &areaOptions = area < hotAreas.size() ? hotAreaOptions : options;
+            while (!stopCondition.isReached()) {
+                const auto [message, region] = decodeNext(decodeGuard.getDecoder(), areaOptions);
+                if (!message) {
+                    break;
+                }
+                const CodePosition position = getPosition(image, region.get());
+                if (observation.contains(position)) {
+                    continue;
+                }
+                DecodeResult decodeResult{reinterpret_cast<const char *>(message->output), position};
+
+                observation.add(position);
+                stopCondition.add(decodeResult.text);
+                co_yield decodeResult;
+                startHotAreaTimeout();
+            }
+            if (options.shouldStop()) {
+                break;
+            }
         }
     }
 
-    void LibdmtxCodeReader::setTimeout(uint32_t msec) { m_timeoutMSec = msec; }
-    uint32_t LibdmtxCodeReader::getTimeout() const { return m_timeoutMSec; }
+    MemoryUsage LibdmtxCodeReader::estimateMemoryUsage(const ImageView &image, const DecodeOptions &options) const {
+        return detail::usageOf(detail::planScan(image, options, libdmtxBytesPerPixel), image,
+                               &MemoryUsage::libdmtxCache);
+    }
+
+    const DecodeOptions &LibdmtxCodeReader::getDefaultOptions() const { return m_defaultOptions; }
+
+    void LibdmtxCodeReader::setTimeout(uint32_t msec) { m_defaultOptions.timeoutMSec = msec; }
+    uint32_t LibdmtxCodeReader::getTimeout() const { return m_defaultOptions.timeoutMSec; }
 
     bool LibdmtxCodeReader::isTimeoutSupported() { return true; }
 
-    void LibdmtxCodeReader::setMaximumNumberOfCodesToDetect(size_t count) { m_maximumNumberOfCodesToDetect = count; }
+    void LibdmtxCodeReader::setMaximumNumberOfCodesToDetect(size_t count) {
+        m_defaultOptions.maximumNumberOfCodesToDetect = count;
+    }
 
-    size_t LibdmtxCodeReader::getMaximumNumberOfCodesToDetect() const { return m_maximumNumberOfCodesToDetect; }
+    size_t LibdmtxCodeReader::getMaximumNumberOfCodesToDetect() const {
+        return m_defaultOptions.maximumNumberOfCodesToDetect;
+    }
     bool LibdmtxCodeReader::isDecodeWithCallbackSupported() { return true; }
+
+    void LibdmtxCodeReader::setHints(const DecodeHints &hints) {
+        // fail here instead of in the next decode call
+        for (const auto &size: hints.symbolSizes) {
+            (void) toDmtxSymbolSize(size);
+        }
+        m_defaultOptions.hints = hints;
+    }
+    const DecodeHints &LibdmtxCodeReader::getHints() const { return m_defaultOptions.hints; }
 } // namespace sfdm
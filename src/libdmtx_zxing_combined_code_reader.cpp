@@ -1,24 +1,18 @@
 #include <sfdm/libdmtx_zxing_combined_code_reader.hpp>
 
+#include "code_position_utils.hpp"
+#include "quality_gate_utils.hpp"
+#include "stop_condition.hpp"
+
+#include <algorithm>
 #include <future>
 #include <stdexcept>
+#include <stop_token>
 #include <thread>
 
 namespace {
-    template<size_t distance = 5>
-    bool within5Pixels(const sfdm::Point &p1, const sfdm::Point &p2) {
-        const auto dx = p1.x - p2.x;
-        const auto dy = p1.y - p2.y;
-        return dx * dx + dy * dy <= distance * distance;
-    }
+    using sfdm::detail::diagonallyOppositeMatch;
 
-    bool diagonallyOppositeMatch(const sfdm::CodePosition &q1, const sfdm::CodePosition &q2) {
-        if (within5Pixels(q1.bottomLeft, q2.bottomLeft) && within5Pixels(q1.topRight, q2.topRight)) {
-            return true;
-        }
-
-        return within5Pixels(q1.topLeft, q2.topLeft) && within5Pixels(q1.bottomRight, q2.bottomRight);
-    }
     std::vector<sfdm::DecodeResult> filterDuplicates(const std::vector<sfdm::DecodeResult> &input1,
                                                      const std::vector<sfdm::DecodeResult> &input2) {
         std::vector<sfdm::DecodeResult> results;
@@ -37,22 +31,38 @@ namespace {
 } // namespace
 
 namespace sfdm {
-    std::vector<DecodeResult> LibdmtxZXingCombinedCodeReader::decode(const ImageView &image) const {
-        const auto maximumNumberOfCodesToDetect = getMaximumNumberOfCodesToDetect();
+    std::vector<DecodeResult> LibdmtxZXingCombinedCodeReader::decode(const ImageView &image,
+                                                                     const DecodeOptions &options) const {
+        // measured once here, the backends get the options without quality gate
+        if (options.qualityGate) {
+            return detail::withQualityGate(image, options, [&](const DecodeOptions &gatedOptions) {
+                return decode(image, gatedOptions);
+            });
+        }
+
         std::vector<DecodeResult> results;
-        results.reserve(maximumNumberOfCodesToDetect);
+        results.reserve(std::min<size_t>(options.maximumNumberOfCodesToDetect, 255));
+        // both backends feed the same stop condition, guarded by resultsMutex
+        detail::StopCondition stopCondition(options);
 
         std::mutex resultsMutex;
         std::atomic<size_t> zXingCount = 0;
 
-        std::thread libdmtxThread([&] {
-            auto stream = m_libdmtxCodeReader.decodeStream(image);
+        // the backend, that reaches the stop condition first, stops the other one
+        std::stop_source stopSource;
+        const std::stop_callback forwardStop(options.stopToken, [&] { stopSource.request_stop(); });
+        auto backendOptions = options;
+        backendOptions.stopToken = stopSource.get_token();
+
+        const auto decodeLibdmtx = [&] {
+            auto stream = m_libdmtxCodeReader.decodeStream(image, backendOptions);
             size_t checkedCount = 0;
             bool doubleCheckZXing = m_doubleCheckZXing;
             while (stream.next()) {
-                const auto result = stream.value();
+                const auto &result = stream.value();
                 std::lock_guard lock(resultsMutex);
-                if (!doubleCheckZXing && results.size() == maximumNumberOfCodesToDetect) {
+                if (!doubleCheckZXing && stopCondition.isReached()) {
+                    stopSource.request_stop();
                     return;
                 }
                 const auto it = std::ranges::find_if(results, [&](const DecodeResult &res) {
@@ -60,59 +70,164 @@ namespace sfdm {
                 });
                 if (results.end() == it) {
                     results.emplace_back(result);
+                    stopCondition.add(result.text);
                 } else {
                     if (doubleCheckZXing) {
                         // we cannot trust zxing decoding. some results are wrong. libdmtx works better.
                         if (it->text != result.text) {
+                            stopCondition.replace(it->text, result.text);
                             *it = result;
                         }
-                        if (results.size() == maximumNumberOfCodesToDetect && ++checkedCount == zXingCount) {
+                        if (stopCondition.isReached() && ++checkedCount == zXingCount) {
                             return;
                         }
                     }
                 }
-                if (!doubleCheckZXing && results.size() == maximumNumberOfCodesToDetect) {
+                if (!doubleCheckZXing && stopCondition.isReached()) {
+                    // the remaining ZXing effort levels are skipped, their results would be dropped anyway
+                    stopSource.request_stop();
                     return;
                 }
             }
-        });
-        std::thread zxingThread([&] {
-            const auto result = m_zxingCodeReader.decode(image);
+        };
+        const auto decodeZXing = [&] {
+            const auto result = m_zxingCodeReader.decode(image, backendOptions);
             std::lock_guard lock(resultsMutex);
-            if (results.size() == maximumNumberOfCodesToDetect) {
+            if (stopCondition.isReached()) {
                 return;
             }
             const auto filteredResults = filterDuplicates(result, results);
             zXingCount = results.size();
-            results.insert(results.end(), filteredResults.begin(), filteredResults.end());
-        });
+            for (const auto &filteredResult: filteredResults) {
+                results.emplace_back(filteredResult);
+                stopCondition.add(filteredResult.text);
+            }
+            // without double check, libdmtx has nothing left to do. Its region search ends within one time slice.
+            if (!m_doubleCheckZXing && stopCondition.isReached()) {
+                stopSource.request_stop();
+            }
+        };
 
-        zxingThread.join();
-        libdmtxThread.join();
+        if (options.memoryLimit && estimateMemoryUsage(image, options).serialized) {
+            // ZXing first, so libdmtx double checks its results as it does concurrently
+            decodeZXing();
+            decodeLibdmtx();
+        } else {
+            std::thread libdmtxThread(decodeLibdmtx);
+            std::thread zxingThread(decodeZXing);
+            zxingThread.join();
+            libdmtxThread.join();
+        }
         results.shrink_to_fit();
 
         return results;
     }
     std::vector<DecodeResult> LibdmtxZXingCombinedCodeReader::decode(const ImageView &image,
+                                                                     const DecodeOptions &options,
                                                                      std::function<void(DecodeResult)> callback) const {
         (void) image;
+        (void) options;
         (void) callback;
         throw std::runtime_error("Decode with callback is not supported!");
     }
 
-    void LibdmtxZXingCombinedCodeReader::setTimeout(uint32_t msec) { m_libdmtxCodeReader.setTimeout(msec); }
-    uint32_t LibdmtxZXingCombinedCodeReader::getTimeout() const { return m_libdmtxCodeReader.getTimeout(); }
+    std::vector<DetectionResult> LibdmtxZXingCombinedCodeReader::detect(const ImageView &image,
+                                                                        const DecodeOptions &options) const {
+        if (options.qualityGate) {
+            return detail::withQualityGate(image, options, [&](const DecodeOptions &gatedOptions) {
+                return detect(image, gatedOptions);
+            });
+        }
+
+        std::stop_source stopSource;
+        const std::stop_callback forwardStop(options.stopToken, [&] { stopSource.request_stop(); });
+        auto backendOptions = options;
+        backendOptions.stopToken = stopSource.get_token();
+
+        auto zxingDetections = std::async(std::launch::async, [&] {
+            auto found = m_zxingCodeReader.detect(image, backendOptions);
+            if (found.size() >= options.maximumNumberOfCodesToDetect) {
+                stopSource.request_stop();
+            }
+            return found;
+        });
+        auto detections = m_libdmtxCodeReader.detect(image, backendOptions);
+        if (detections.size() >= options.maximumNumberOfCodesToDetect) {
+            stopSource.request_stop();
+        }
+        for (auto &zxingDetection: zxingDetections.get()) {
+            if (detections.size() >= options.maximumNumberOfCodesToDetect) {
+                break;
+            }
+            const bool isDuplicate = std::ranges::any_of(detections, [&](const DetectionResult &detection) {
+                return diagonallyOppositeMatch(detection.position, zxingDetection.position);
+            });
+            if (!isDuplicate) {
+                detections.emplace_back(std::move(zxingDetection));
+            }
+        }
+        return detections;
+    }
+
+    std::optional<DecodeResult> LibdmtxZXingCombinedCodeReader::decode(const ImageView &image,
+                                                                       const DetectionResult &detection,
+                                                                       const DecodeOptions &options) const {
+        if (auto result = m_libdmtxCodeReader.decode(image, detection, options)) {
+            return result;
+        }
+        return m_zxingCodeReader.decode(image, detection, options);
+    }
+
+    MemoryUsage LibdmtxZXingCombinedCodeReader::estimateMemoryUsage(const ImageView &image,
+                                                                    const DecodeOptions &options) const {
+        auto unlimitedOptions = options;
+        unlimitedOptions.memoryLimit.reset();
+        auto libdmtxUsage = m_libdmtxCodeReader.estimateMemoryUsage(image, unlimitedOptions);
+        auto zxingUsage = m_zxingCodeReader.estimateMemoryUsage(image, unlimitedOptions);
+
+        MemoryUsage usage;
+        if (!options.memoryLimit || libdmtxUsage.peak + zxingUsage.peak <= *options.memoryLimit) {
+            usage.libdmtxCache = libdmtxUsage.libdmtxCache;
+            usage.zxingBuffers = zxingUsage.zxingBuffers;
+            usage.peak = libdmtxUsage.peak + zxingUsage.peak;
+            return usage;
+        }
+
+        // one backend after the other, each of them may use the whole limit
+        libdmtxUsage = m_libdmtxCodeReader.estimateMemoryUsage(image, options);
+        zxingUsage = m_zxingCodeReader.estimateMemoryUsage(image, options);
+        usage.libdmtxCache = libdmtxUsage.libdmtxCache;
+        usage.zxingBuffers = zxingUsage.zxingBuffers;
+        usage.imageCopies = std::max(libdmtxUsage.imageCopies, zxingUsage.imageCopies);
+        usage.peak = std::max(libdmtxUsage.peak, zxingUsage.peak);
+        usage.serialized = true;
+        usage.striped = libdmtxUsage.striped || zxingUsage.striped;
+        usage.downscaled = libdmtxUsage.downscaled || zxingUsage.downscaled;
+        usage.withinLimit = libdmtxUsage.withinLimit || zxingUsage.withinLimit;
+        return usage;
+    }
+
+    const DecodeOptions &LibdmtxZXingCombinedCodeReader::getDefaultOptions() const { return m_defaultOptions; }
+
+    void LibdmtxZXingCombinedCodeReader::setTimeout(uint32_t msec) { m_defaultOptions.timeoutMSec = msec; }
+    uint32_t LibdmtxZXingCombinedCodeReader::getTimeout() const { return m_defaultOptions.timeoutMSec; }
 
     bool LibdmtxZXingCombinedCodeReader::isTimeoutSupported() { return true; }
 
     void LibdmtxZXingCombinedCodeReader::setMaximumNumberOfCodesToDetect(size_t count) {
-        m_libdmtxCodeReader.setMaximumNumberOfCodesToDetect(count);
+        // validates the count for the zxing backend
         m_zxingCodeReader.setMaximumNumberOfCodesToDetect(count);
+        m_defaultOptions.maximumNumberOfCodesToDetect = count;
     }
     size_t LibdmtxZXingCombinedCodeReader::getMaximumNumberOfCodesToDetect() const {
-        return m_libdmtxCodeReader.getMaximumNumberOfCodesToDetect();
+        return m_defaultOptions.maximumNumberOfCodesToDetect;
     }
     bool LibdmtxZXingCombinedCodeReader::isDecodeWithCallbackSupported() { return false; }
+    void LibdmtxZXingCombinedCodeReader::setHints(const DecodeHints &hints) {
+        m_libdmtxCodeReader.setHints(hints);
+        m_defaultOptions.hints = hints;
+    }
+    const DecodeHints &LibdmtxZXingCombinedCodeReader::getHints() const { return m_defaultOptions.hints; }
     void LibdmtxZXingCombinedCodeReader::setDoubleCheckZXing(bool value) { m_doubleCheckZXing = value; }
     bool LibdmtxZXingCombinedCodeReader::getDoubleCheckZXing() const { return m_doubleCheckZXing; }
 } // namespace sfdm
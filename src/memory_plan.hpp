@@ -0,0 +1,199 @@
+#pragma once
+#include <algorithm>
+#include <optional>
+#include <sfdm/decode_options.hpp>
+#include <sfdm/decode_result.hpp>
+#include <sfdm/memory_usage.hpp>
+#include <vector>
+
+#include "code_position_utils.hpp"
+#include "decode_hints_utils.hpp"
+#include "stop_condition.hpp"
+
+namespace sfdm::detail {
+    // committed stack of a thread running a callback, estimated
+    constexpr size_t callbackThreadBytes = 64 * 1024;
+    constexpr uint32_t maximumDownscaleFactor = 8;
+    // rows shared by two strips, if the hints do not limit the size of the codes
+    constexpr size_t defaultStripOverlap = 256;
+
+    /*!
+     * How a backend scans an image within the memory limit. Horizontal strips of full rows are contiguous, so they are
+     * views into the (downscaled) image and need no copy.
+     */
+    struct ScanLayout {
+        uint32_t downscaleFactor{1};
+        /*!
+         * Rows of the scanned image decoded together
+         */
+        size_t stripHeight{};
+        size_t overlap{};
+        size_t copyBytes{};
+        /*!
+         * Working memory of the backend for one strip
+         */
+        size_t workingBytes{};
+
+        [[nodiscard]] bool isStriped(const ImageView &image) const {
+            return stripHeight < image.height / downscaleFactor;
+        }
+        [[nodiscard]] bool isOriginal(const ImageView &image) const {
+            return downscaleFactor == 1 && !isStriped(image);
+        }
+    };
+
+    /*!
+     * Chooses how the image is scanned within the memory limit of the options. The whole image is preferred, then
+     * strips at full resolution, then downscaled copies, that are scanned whole or in strips.
+     * @param bytesPerPixel working memory of the backend per scanned pixel
+     * @return Layout, or nothing if no layout stays below the limit
+     */
+    inline std::optional<ScanLayout> planScan(const ImageView &image, const DecodeOptions &options,
+                                              double bytesPerPixel) {
+        const auto working = [&](size_t width, size_t rows) {
+            return static_cast<size_t>(bytesPerPixel * static_cast<double>(width * rows));
+        };
+        if (!options.memoryLimit) {
+            return ScanLayout{1, image.height, 0, 0, working(image.width, image.height)};
+        }
+        const auto limit = *options.memoryLimit;
+        // every code has to lie completely inside one strip, with the slack of matchesHints
+        const auto maxEdgeLength = edgeLengthRange(options.hints).max;
+        const size_t overlap = maxEdgeLength ? *maxEdgeLength + *maxEdgeLength / 10 : defaultStripOverlap;
+
+        for (uint32_t factor = 1; factor <= maximumDownscaleFactor; ++factor) {
+            const auto width = image.width / factor;
+            const auto height = image.height / factor;
+            const auto copyBytes = factor > 1 ? width * height : 0;
+            if (width == 0 || height == 0 || copyBytes >= limit) {
+                break;
+            }
+            if (copyBytes + working(width, height) <= limit) {
+                return ScanLayout{factor, height, 0, copyBytes, working(width, height)};
+            }
+            const auto stripOverlap = (overlap + factor - 1) / factor;
+            const auto stripHeight =
+                    static_cast<size_t>(static_cast<double>(limit - copyBytes) / (bytesPerPixel * width));
+            if (stripHeight > 0 && stripHeight >= 2 * stripOverlap) {
+                return ScanLayout{factor, stripHeight, stripOverlap, copyBytes, working(width, stripHeight)};
+            }
+        }
+        return std::nullopt;
+    }
+
+    /*!
+     * Usage of a single backend scanning the image in the layout.
+     * @param component the member of MemoryUsage, that receives the working memory
+     */
+    inline MemoryUsage usageOf(const std::optional<ScanLayout> &layout, const ImageView &image,
+                               size_t MemoryUsage::*component) {
+        MemoryUsage usage;
+        if (!layout) {
+            usage.withinLimit = false;
+            return usage;
+        }
+        usage.*component = layout->workingBytes;
+        usage.imageCopies = layout->copyBytes;
+        usage.peak = layout->workingBytes + layout->copyBytes;
+        usage.striped = layout->isStriped(image);
+        usage.downscaled = layout->downscaleFactor > 1;
+        return usage;
+    }
+
+    /*!
+     * Box filtered copy of the image, factor times smaller in both directions.
+     */
+    inline ImageView downscale(const ImageView &image, uint32_t factor, std::vector<uint8_t> &pixels) {
+        const auto width = image.width / factor;
+        const auto height = image.height / factor;
+        pixels.resize(width * height);
+        std::vector<uint32_t> sums(width);
+        for (size_t y = 0; y < height; ++y) {
+            std::ranges::fill(sums, 0U);
+            for (size_t dy = 0; dy < factor; ++dy) {
+                const uint8_t *row = image.data + (y * factor + dy) * image.width;
+                for (size_t x = 0; x < width; ++x) {
+                    for (size_t dx = 0; dx < factor; ++dx) {
+                        sums[x] += row[x * factor + dx];
+                    }
+                }
+            }
+            for (size_t x = 0; x < width; ++x) {
+                pixels[y * width + x] = static_cast<uint8_t>(sums[x] / (factor * factor));
+            }
+        }
+        return {width, height, pixels.data()};
+    }
+
+    /*!
+     * Hints in pixels of an image, that is factor times smaller.
+     */
+    inline DecodeHints scaledHints(DecodeHints hints, uint32_t factor) {
+        if (hints.minModuleSize) {
+            hints.minModuleSize = std::max(1U, *hints.minModuleSize / factor);
+        }
+        if (hints.maxModuleSize) {
+            hints.maxModuleSize = (*hints.maxModuleSize + factor - 1) / factor;
+        }
+        if (hints.scanGap) {
+            hints.scanGap = std::max(1U, *hints.scanGap / factor);
+        }
+        return hints;
+    }
+
+    /*!
+     * Maps a position in an image, that is factor times smaller, onto the image. Points land in the center of their
+     * block.
+     */
+    inline CodePosition upscale(const CodePosition &position, uint32_t factor) {
+        if (factor == 1) {
+            return position;
+        }
+        const auto point = [&](const Point &p) {
+            return Point{p.x * factor + factor / 2, p.y * factor + factor / 2};
+        };
+        return {point(position.bottomLeft), point(position.topLeft), point(position.topRight),
+                point(position.bottomRight)};
+    }
+
+    /*!
+     * Decodes the image strip by strip in the layout. Codes in the overlap of two strips are returned once.
+     * @param decodeStrip decodes one strip with the options it is passed, that have no memory limit
+     */
+    template<typename DecodeStrip>
+    std::vector<DecodeResult> decodeInLayout(const ImageView &image, const DecodeOptions &options,
+                                             const ScanLayout &layout, const DecodeStrip &decodeStrip) {
+        const auto factor = layout.downscaleFactor;
+        std::vector<uint8_t> pixels;
+        const auto scanned = factor > 1 ? downscale(image, factor, pixels) : image;
+        auto stripOptions = options;
+        stripOptions.memoryLimit.reset();
+        stripOptions.locationPrior.reset();
+        stripOptions.hints = scaledHints(options.hints, factor);
+
+        std::vector<DecodeResult> results;
+        StopCondition stopCondition(options);
+        size_t top = 0;
+        while (!stopCondition.isReached() && !options.shouldStop()) {
+            const auto rows = std::min(layout.stripHeight, scanned.height - top);
+            const ImageView strip{scanned.width, rows, scanned.data + top * scanned.width};
+            for (auto &result: decodeStrip(strip, stripOptions)) {
+                if (stopCondition.isReached()) {
+                    break;
+                }
+                result.position = upscale(translate(result.position, 0, static_cast<uint32_t>(top)), factor);
+                const bool isDuplicate = std::ranges::any_of(
+                        results, [&](const DecodeResult &found) { return isSameCode(found, result); });
+                if (!isDuplicate) {
+                    stopCondition.add(result.text);
+                    results.emplace_back(std::move(result));
+                }
+            }
+            if (top + rows >= scanned.height) {
+                break;
+            }
+            top += layout.stripHeight - layout.overlap;
+        }
+        return results;
+    }
+} // namespace sfdm::detail
@@ -0,0 +1,24 @@
+#pragma once
+#include <sfdm/decode_options.hpp>
+#include <sfdm/image_quality.hpp>
+#include <sfdm/image_view.hpp>
+#include <type_traits>
+
+namespace sfdm::detail {
+    /*!
+     * Applies the quality gate of the options and runs the call with the resulting options, that no longer carry a
+     * gate. Readers call it from their decode and detect functions, when the options have a quality gate.
+     * @param call decode or detect call, taking the options to use
+     * @return Result of the call. Empty, if the gate rejected the frame.
+     */
+    template<typename Call>
+    auto withQualityGate(const ImageView &image, const DecodeOptions &options, Call &&call) {
+        using Result = std::invoke_result_t<Call &, const DecodeOptions &>;
+        DecodeReport report;
+        const auto gatedOptions = applyQualityGate(image, options, report);
+        if (!gatedOptions) {
+            return Result();
+        }
+        return call(*gatedOptions);
+    }
+} // namespace sfdm::detail
@@ -0,0 +1,358 @@
+#include <sfdm/reader_config.hpp>
+#include <sfdm/sfdm_config.hpp>
+#include <sfdm/variant_racing_code_reader.hpp>
+
+#ifdef SFDM_WITH_ZXING_DECODER
+#include <sfdm/zxing_code_reader.hpp>
+#endif
+#ifdef SFDM_WITH_LIBDMTX_DECODER
+#include <sfdm/libdmtx_code_reader.hpp>
+#endif
+#if defined(SFDM_WITH_ZXING_DECODER) && defined(SFDM_WITH_LIBDMTX_DECODER)
+#include <sfdm/libdmtx_zxing_combined_code_reader.hpp>
+#endif
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+    std::string_view trim(std::string_view value) {
+        constexpr std::string_view whitespace = " \t\r\n";
+        const auto begin = value.find_first_not_of(whitespace);
+        if (begin == std::string_view::npos) {
+            return {};
+        }
+        const auto end = value.find_last_not_of(whitespace);
+        return value.substr(begin, end - begin + 1);
+    }
+
+    uint32_t parseUnsigned(std::string_view key, std::string_view value) {
+        uint32_t result{};
+        const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (ec != std::errc{} || ptr != value.data() + value.size()) {
+            throw std::runtime_error{"Invalid value for " + std::string{key} + ": " + std::string{value}};
+        }
+        return result;
+    }
+
+    size_t parseSize(std::string_view key, std::string_view value) {
+        size_t result{};
+        const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (ec != std::errc{} || ptr != value.data() + value.size()) {
+            throw std::runtime_error{"Invalid value for " + std::string{key} + ": " + std::string{value}};
+        }
+        return result;
+    }
+
+    double parseDouble(std::string_view key, std::string_view value) {
+        double result{};
+        const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (ec != std::errc{} || ptr != value.data() + value.size()) {
+            throw std::runtime_error{"Invalid value for " + std::string{key} + ": " + std::string{value}};
+        }
+        return result;
+    }
+
+    // shortest form, that reads back to the same value
+    std::string formatDouble(double value) {
+        char buffer[32];
+        const auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        return {buffer, ptr};
+    }
+
+    std::string_view symbolShapeToString(sfdm::SymbolShape shape) {
+        switch (shape) {
+            case sfdm::SymbolShape::Any:
+                return "any";
+            case sfdm::SymbolShape::Square:
+                return "square";
+            case sfdm::SymbolShape::Rectangle:
+                return "rectangle";
+        }
+        throw std::runtime_error{"Unknown symbol shape!"};
+    }
+
+    sfdm::SymbolShape symbolShapeFromString(std::string_view key, std::string_view value) {
+        for (const auto shape: {sfdm::SymbolShape::Any, sfdm::SymbolShape::Square, sfdm::SymbolShape::Rectangle}) {
+            if (value == symbolShapeToString(shape)) {
+                return shape;
+            }
+        }
+        throw std::runtime_error{"Invalid value for " + std::string{key} + ": " + std::string{value}};
+    }
+
+    std::string_view qualityActionToString(sfdm::QualityAction action) {
+        switch (action) {
+            case sfdm::QualityAction::Decode:
+                return "decode";
+            case sfdm::QualityAction::Downgrade:
+                return "downgrade";
+            case sfdm::QualityAction::Reject:
+                return "reject";
+        }
+        throw std::runtime_error{"Unknown quality action!"};
+    }
+
+    sfdm::QualityAction qualityActionFromString(std::string_view key, std::string_view value) {
+        for (const auto action: {sfdm::QualityAction::Decode, sfdm::QualityAction::Downgrade,
+                                 sfdm::QualityAction::Reject}) {
+            if (value == qualityActionToString(action)) {
+                return action;
+            }
+        }
+        throw std::runtime_error{"Invalid value for " + std::string{key} + ": " + std::string{value}};
+    }
+
+    // rows x columns, separated by commas, e.g. 16x16,12x36
+    std::vector<sfdm::SymbolSize> parseSymbolSizes(std::string_view key, std::string_view value) {
+        std::vector<sfdm::SymbolSize> sizes;
+        while (!value.empty()) {
+            const auto end = std::min(value.find(','), value.size());
+            const auto size = value.substr(0, end);
+            const auto separator = size.find('x');
+            if (separator == std::string_view::npos) {
+                throw std::runtime_error{"Invalid value for " + std::string{key} + ": " + std::string{size}};
+            }
+            sizes.push_back({parseUnsigned(key, size.substr(0, separator)),
+                             parseUnsigned(key, size.substr(separator + 1))});
+            value.remove_prefix(std::min(end + 1, value.size()));
+        }
+        return sizes;
+    }
+
+    bool parseBool(std::string_view key, std::string_view value) {
+        if (value == "true" || value == "1") {
+            return true;
+        }
+        if (value == "false" || value == "0") {
+            return false;
+        }
+        throw std::runtime_error{"Invalid value for " + std::string{key} + ": " + std::string{value}};
+    }
+
+    std::unique_ptr<sfdm::ICodeReader> createBackend(const sfdm::ReaderConfig &config) {
+        switch (config.backend) {
+            case sfdm::ReaderBackend::ZXing:
+#ifdef SFDM_WITH_ZXING_DECODER
+                return std::make_unique<sfdm::ZXingCodeReader>();
+#else
+                break;
+#endif
+            case sfdm::ReaderBackend::Libdmtx: {
+#ifdef SFDM_WITH_LIBDMTX_DECODER
+                auto reader = std::make_unique<sfdm::LibdmtxCodeReader>();
+                reader->setTimeout(config.timeoutMSec);
+                return reader;
+#else
+                break;
+#endif
+            }
+            case sfdm::ReaderBackend::Combined: {
+#if defined(SFDM_WITH_ZXING_DECODER) && defined(SFDM_WITH_LIBDMTX_DECODER)
+                auto reader = std::make_unique<sfdm::LibdmtxZXingCombinedCodeReader>();
+                reader->setTimeout(config.timeoutMSec);
+                reader->setDoubleCheckZXing(config.doubleCheckZXing);
+                return reader;
+#else
+                break;
+#endif
+            }
+        }
+        throw std::runtime_error{"Backend " + sfdm::toString(config.backend) + " is not available in this build!"};
+    }
+} // namespace
+
+namespace sfdm {
+    std::string toString(ReaderBackend backend) {
+        switch (backend) {
+            case ReaderBackend::ZXing:
+                return "zxing";
+            case ReaderBackend::Libdmtx:
+                return "libdmtx";
+            case ReaderBackend::Combined:
+                return "combined";
+        }
+        throw std::runtime_error{"Unknown reader backend!"};
+    }
+
+    ReaderBackend readerBackendFromString(std::string_view value) {
+        if (value == "zxing") {
+            return ReaderBackend::ZXing;
+        }
+        if (value == "libdmtx") {
+            return ReaderBackend::Libdmtx;
+        }
+        if (value == "combined") {
+            return ReaderBackend::Combined;
+        }
+        throw std::runtime_error{"Unknown reader backend: " + std::string{value}};
+    }
+
+    ReaderConfig readReaderConfig(std::istream &stream) {
+        ReaderConfig config;
+        std::string line;
+        while (std::getline(stream, line)) {
+            const auto content = trim(line);
+            if (content.empty() || content.front() == '#') {
+                continue;
+            }
+            const auto pos = content.find('=');
+            if (pos == std::string_view::npos) {
+                throw std::runtime_error{"Invalid config line: " + std::string{content}};
+            }
+            const auto key = trim(content.substr(0, pos));
+            const auto value = trim(content.substr(pos + 1));
+
+            if (key == "backend") {
+                config.backend = readerBackendFromString(value);
+            } else if (key == "timeout") {
+                config.timeoutMSec = parseUnsigned(key, value);
+            } else if (key == "double_check_zxing") {
+                config.doubleCheckZXing = parseBool(key, value);
+            } else if (key == "try_inverted") {
+                config.tryInverted = parseBool(key, value);
+            } else if (key == "try_mirrored") {
+                config.tryMirrored = parseBool(key, value);
+            } else {
+                throw std::runtime_error{"Unknown config key: " + std::string{key}};
+            }
+        }
+        return config;
+    }
+
+    void writeReaderConfig(std::ostream &stream, const ReaderConfig &config) {
+        stream << "backend=" << toString(config.backend) << '\n';
+        stream << "timeout=" << config.timeoutMSec << '\n';
+        stream << "double_check_zxing=" << (config.doubleCheckZXing ? "true" : "false") << '\n';
+        stream << "try_inverted=" << (config.tryInverted ? "true" : "false") << '\n';
+        stream << "try_mirrored=" << (config.tryMirrored ? "true" : "false") << '\n';
+    }
+
+    void writeDecodeOptions(std::ostream &stream, const DecodeOptions &options) {
+        stream << "timeout=" << options.timeoutMSec << '\n';
+        stream << "codes=" << options.maximumNumberOfCodesToDetect << '\n';
+
+        const auto &hints = options.hints;
+        if (!hints.symbolSizes.empty()) {
+            stream << "symbol_sizes=";
+            for (size_t i = 0; i < hints.symbolSizes.size(); ++i) {
+                stream << (i ? "," : "") << hints.symbolSizes[i].rows << 'x' << hints.symbolSizes[i].columns;
+            }
+            stream << '\n';
+        }
+        stream << "shape=" << symbolShapeToString(hints.shape) << '\n';
+        const auto writeOptional = [&](std::string_view key, const auto &value) {
+            if (value) {
+                stream << key << '=' << *value << '\n';
+            }
+        };
+        writeOptional("min_module_size", hints.minModuleSize);
+        writeOptional("max_module_size", hints.maxModuleSize);
+        writeOptional("edge_threshold", hints.edgeThreshold);
+        writeOptional("square_deviation", hints.squareDeviation);
+        writeOptional("scan_gap", hints.scanGap);
+        writeOptional("max_effort_levels", options.maximumEffortLevels);
+        writeOptional("memory_limit", options.memoryLimit);
+
+        if (const auto &gate = options.qualityGate) {
+            stream << "quality_min_sharpness=" << formatDouble(gate->minSharpness) << '\n';
+            stream << "quality_min_contrast=" << formatDouble(gate->minContrast) << '\n';
+            stream << "quality_max_overexposed=" << formatDouble(gate->maxOverexposedFraction) << '\n';
+            stream << "quality_max_underexposed=" << formatDouble(gate->maxUnderexposedFraction) << '\n';
+            stream << "quality_action=" << qualityActionToString(gate->onFailure) << '\n';
+            stream << "quality_sample_step=" << gate->sampleStep << '\n';
+            stream << "quality_downgraded_timeout=" << gate->downgradedTimeoutMSec << '\n';
+            stream << "quality_downgraded_effort_levels=" << gate->downgradedEffortLevels << '\n';
+        }
+    }
+
+    bool readDecodeOption(DecodeOptions &options, std::string_view key, std::string_view value) {
+        auto &hints = options.hints;
+        if (key == "timeout") {
+            options.timeoutMSec = parseUnsigned(key, value);
+        } else if (key == "codes") {
+            options.maximumNumberOfCodesToDetect = parseSize(key, value);
+        } else if (key == "symbol_sizes") {
+            hints.symbolSizes = parseSymbolSizes(key, value);
+        } else if (key == "shape") {
+            hints.shape = symbolShapeFromString(key, value);
+        } else if (key == "min_module_size") {
+            hints.minModuleSize = parseUnsigned(key, value);
+        } else if (key == "max_module_size") {
+            hints.maxModuleSize = parseUnsigned(key, value);
+        } else if (key == "edge_threshold") {
+            hints.edgeThreshold = parseUnsigned(key, value);
+        } else if (key == "square_deviation") {
+            hints.squareDeviation = parseUnsigned(key, value);
+        } else if (key == "scan_gap") {
+            hints.scanGap = parseUnsigned(key, value);
+        } else if (key == "max_effort_levels") {
+            options.maximumEffortLevels = parseSize(key, value);
+        } else if (key == "memory_limit") {
+            options.memoryLimit = parseSize(key, value);
+        } else if (key.starts_with("quality_")) {
+            auto gate = options.qualityGate.value_or(QualityGate{});
+            if (key == "quality_min_sharpness") {
+                gate.minSharpness = parseDouble(key, value);
+            } else if (key == "quality_min_contrast") {
+                gate.minContrast = parseDouble(key, value);
+            } else if (key == "quality_max_overexposed") {
+                gate.maxOverexposedFraction = parseDouble(key, value);
+            } else if (key == "quality_max_underexposed") {
+                gate.maxUnderexposedFraction = parseDouble(key, value);
+            } else if (key == "quality_action") {
+                gate.onFailure = qualityActionFromString(key, value);
+            } else if (key == "quality_sample_step") {
+                gate.sampleStep = parseSize(key, value);
+            } else if (key == "quality_downgraded_timeout") {
+                gate.downgradedTimeoutMSec = parseUnsigned(key, value);
+            } else if (key == "quality_downgraded_effort_levels") {
+                gate.downgradedEffortLevels = parseSize(key, value);
+            } else {
+                return false;
+            }
+            options.qualityGate = gate;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    ReaderConfig loadReaderConfig(const std::filesystem::path &path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            throw std::runtime_error{"Could not open config file: " + path.string()};
+        }
+        return readReaderConfig(file);
+    }
+
+    void saveReaderConfig(const std::filesystem::path &path, const ReaderConfig &config) {
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            throw std::runtime_error{"Could not open config file: " + path.string()};
+        }
+        writeReaderConfig(file, config);
+    }
+
+    std::unique_ptr<ICodeReader> createCodeReader(const ReaderConfig &config) {
+        auto backend = createBackend(config);
+        if (!config.tryInverted && !config.tryMirrored) {
+            return backend;
+        }
+        std::vector variants{ImageVariant::Normal};
+        if (config.tryInverted) {
+            variants.push_back(ImageVariant::Inverted);
+        }
+        if (config.tryMirrored) {
+            variants.push_back(ImageVariant::Mirrored);
+            if (config.tryInverted) {
+                variants.push_back(ImageVariant::InvertedMirrored);
+            }
+        }
+        return std::make_unique<VariantRacingCodeReader>(std::move(backend), std::move(variants));
+    }
+} // namespace sfdm
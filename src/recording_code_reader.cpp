@@ -0,0 +1,261 @@
+#include <sfdm/recording_code_reader.hpp>
+
+#include "bounded_mpmc_queue.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    void appendEscaped(std::string &out, std::string_view text) {
+        for (const char c: text) {
+            switch (c) {
+                case '\\':
+                    out += "\\\\";
+                    break;
+                case '\n':
+                    out += "\\n";
+                    break;
+                case '\r':
+                    out += "\\r";
+                    break;
+                default:
+                    out += c;
+            }
+        }
+    }
+
+    std::ofstream openForWriting(const std::filesystem::path &path) {
+        std::ofstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error{"Could not open " + path.string()};
+        }
+        return file;
+    }
+} // namespace
+
+namespace sfdm {
+    struct Capture {
+        uint64_t sequence{};
+        size_t width{};
+        size_t height{};
+        std::vector<uint8_t> pixels;
+        // without the members, that refer to the caller's state
+        DecodeOptions options;
+        // time left until the deadline when the call started
+        std::optional<int64_t> deadlineMSec;
+        double milliseconds{};
+        bool slow{};
+        bool missingCodes{};
+        std::vector<DecodeResult> results;
+    };
+
+    struct CaptureQueue {
+        explicit CaptureQueue(size_t capacity) : captures{capacity} {}
+        detail::BoundedMpmcQueue<Capture> captures;
+    };
+
+    RecordingCodeReader::RecordingCodeReader(std::unique_ptr<ICodeReader> backend, SlowFrameRecorderConfig config) :
+        m_backend{std::move(backend)}, m_config{std::move(config)} {
+        if (!m_backend) {
+            throw std::runtime_error{"Recording code reader needs a backend!"};
+        }
+        if (m_config.maximumCaptures == 0) {
+            throw std::runtime_error{"Recording code reader needs at least one capture slot!"};
+        }
+        std::filesystem::create_directories(m_config.directory);
+        m_queue = std::make_unique<CaptureQueue>(m_config.queueCapacity);
+        m_writer = std::jthread([this] { work(); });
+    }
+
+    RecordingCodeReader::~RecordingCodeReader() {
+        m_stopped = true;
+        m_capturesAvailable.release();
+        m_writer = {};
+    }
+
+    std::vector<DecodeResult> RecordingCodeReader::decode(const ImageView &image, const DecodeOptions &options) const {
+        const auto start = std::chrono::steady_clock::now();
+        auto results = m_backend->decode(image, options);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        if (isSlow(elapsed, results.size(), options) && hasFreeCaptureSlot()) {
+            record(image, options, results, elapsed);
+        }
+        return results;
+    }
+
+    std::vector<DecodeResult> RecordingCodeReader::decode(const ImageView &image, const DecodeOptions &options,
+                                                          std::function<void(DecodeResult)> callback) const {
+        const auto start = std::chrono::steady_clock::now();
+        auto results = m_backend->decode(image, options, std::move(callback));
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        if (isSlow(elapsed, results.size(), options) && hasFreeCaptureSlot()) {
+            record(image, options, results, elapsed);
+        }
+        return results;
+    }
+
+    void RecordingCodeReader::decode(const ImageView &image, const DecodeOptions &options,
+                                     DecodeResultBuffer &results) const {
+        const auto start = std::chrono::steady_clock::now();
+        m_backend->decode(image, options, results);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        // results are only copied for slow frames, that fit into the queue, the fast path stays free of allocations
+        if (isSlow(elapsed, results.size(), options) && hasFreeCaptureSlot()) {
+            record(image, options, results.toDecodeResults(), elapsed);
+        }
+    }
+
+    std::vector<DetectionResult> RecordingCodeReader::detect(const ImageView &image,
+                                                             const DecodeOptions &options) const {
+        return m_backend->detect(image, options);
+    }
+
+    std::optional<DecodeResult> RecordingCodeReader::decode(const ImageView &image, const DetectionResult &detection,
+                                                            const DecodeOptions &options) const {
+        return m_backend->decode(image, detection, options);
+    }
+
+    bool RecordingCodeReader::isSlow(std::chrono::steady_clock::duration elapsed, size_t resultCount,
+                                     const DecodeOptions &options) const {
+        return elapsed > m_config.latencyThreshold ||
+               (m_config.recordMissingCodes && resultCount < options.maximumNumberOfCodesToDetect);
+    }
+
+    bool RecordingCodeReader::hasFreeCaptureSlot() const {
+        // checked before the frame is copied, so a writer that is behind does not cost a frame copy per decode
+        if (m_queue->captures.size() < m_queue->captures.capacity()) {
+            return true;
+        }
+        ++m_droppedFrames;
+        return false;
+    }
+
+    void RecordingCodeReader::record(const ImageView &image, const DecodeOptions &options,
+                                     std::vector<DecodeResult> results,
+                                     std::chrono::steady_clock::duration elapsed) const {
+        Capture capture;
+        capture.sequence = m_nextSequence++;
+        capture.width = image.width;
+        capture.height = image.height;
+        // the caller may reuse the frame as soon as decode returns, so it is copied here
+        capture.pixels.assign(image.data, image.data + image.width * image.height);
+        capture.options = options;
+        capture.options.expectedPayloads.reset();
+        capture.options.locationPrior.reset();
+        capture.options.stopToken = {};
+        if (options.deadline) {
+            const auto callStart = std::chrono::steady_clock::now() - elapsed;
+            capture.deadlineMSec =
+                    std::chrono::duration_cast<std::chrono::milliseconds>(*options.deadline - callStart).count();
+        }
+        capture.milliseconds = std::chrono::duration<double, std::milli>(elapsed).count();
+        capture.slow = elapsed > m_config.latencyThreshold;
+        capture.missingCodes = results.size() < options.maximumNumberOfCodesToDetect;
+        capture.results = std::move(results);
+
+        // another thread may have taken the free slot since the check
+        if (!m_queue->captures.tryPush(capture)) {
+            ++m_droppedFrames;
+            return;
+        }
+        m_capturesAvailable.release();
+    }
+
+    void RecordingCodeReader::work() {
+        while (true) {
+            m_capturesAvailable.acquire();
+            while (auto capture = m_queue->captures.tryPop()) {
+                try {
+                    write(*capture);
+                    ++m_recordedFrames;
+                } catch (const std::exception &) {
+                    // a full disk must not take down the decoding, the capture is lost
+                    ++m_droppedFrames;
+                }
+            }
+            if (m_stopped) {
+                return;
+            }
+        }
+    }
+
+    void RecordingCodeReader::write(const Capture &capture) const {
+        const auto slot = std::to_string(capture.sequence % m_config.maximumCaptures);
+        const auto metadataPath = m_config.directory / (slot + ".txt");
+        // the slot is incomplete until the metadata is written again
+        std::filesystem::remove(metadataPath);
+
+        {
+            auto image = openForWriting(m_config.directory / (slot + ".pgm"));
+            image << "P5\n" << capture.width << ' ' << capture.height << "\n255\n";
+            image.write(reinterpret_cast<const char *>(capture.pixels.data()),
+                        static_cast<std::streamsize>(capture.pixels.size()));
+        }
+        if (m_config.readerConfig) {
+            auto config = openForWriting(m_config.directory / (slot + ".cfg"));
+            writeReaderConfig(config, *m_config.readerConfig);
+        } else {
+            std::filesystem::remove(m_config.directory / (slot + ".cfg"));
+        }
+
+        std::string metadata;
+        metadata += "sequence=" + std::to_string(capture.sequence) + '\n';
+        metadata += "reason=";
+        metadata += capture.slow ? (capture.missingCodes ? "latency,missing_codes" : "latency") : "missing_codes";
+        metadata += '\n';
+        metadata += "decode_ms=" + std::to_string(capture.milliseconds) + '\n';
+        // the options, as read back by sfdm_replay
+        std::ostringstream options;
+        writeDecodeOptions(options, capture.options);
+        metadata += options.str();
+        if (capture.deadlineMSec) {
+            metadata += "deadline_ms=" + std::to_string(*capture.deadlineMSec) + '\n';
+        }
+        metadata += "result_count=" + std::to_string(capture.results.size()) + '\n';
+        // result=<bottom left> <top left> <top right> <bottom right> <text>
+        for (const auto &result: capture.results) {
+            metadata += "result=";
+            for (const auto &point: {result.position.bottomLeft, result.position.topLeft, result.position.topRight,
+                                     result.position.bottomRight}) {
+                metadata += std::to_string(point.x) + ',' + std::to_string(point.y) + ' ';
+            }
+            appendEscaped(metadata, result.text);
+            metadata += '\n';
+        }
+
+        const auto temporaryPath = m_config.directory / (slot + ".txt.tmp");
+        {
+            auto file = openForWriting(temporaryPath);
+            file.write(metadata.data(), static_cast<std::streamsize>(metadata.size()));
+        }
+        std::filesystem::rename(temporaryPath, metadataPath);
+    }
+
+    RecorderStatistics RecordingCodeReader::getRecorderStatistics() const {
+        return {m_recordedFrames, m_droppedFrames};
+    }
+
+    MemoryUsage RecordingCodeReader::estimateMemoryUsage(const ImageView &image, const DecodeOptions &options) const {
+        return m_backend->estimateMemoryUsage(image, options);
+    }
+
+    const DecodeOptions &RecordingCodeReader::getDefaultOptions() const { return m_backend->getDefaultOptions(); }
+
+    void RecordingCodeReader::setTimeout(uint32_t msec) { m_backend->setTimeout(msec); }
+    uint32_t RecordingCodeReader::getTimeout() const { return m_backend->getTimeout(); }
+    bool RecordingCodeReader::isTimeoutSupported() { return m_backend->isTimeoutSupported(); }
+
+    void RecordingCodeReader::setMaximumNumberOfCodesToDetect(size_t count) {
+        m_backend->setMaximumNumberOfCodesToDetect(count);
+    }
+    size_t RecordingCodeReader::getMaximumNumberOfCodesToDetect() const {
+        return m_backend->getMaximumNumberOfCodesToDetect();
+    }
+
+    bool RecordingCodeReader::isDecodeWithCallbackSupported() { return m_backend->isDecodeWithCallbackSupported(); }
+
+    void RecordingCodeReader::setHints(const DecodeHints &hints) { m_backend->setHints(hints); }
+    const DecodeHints &RecordingCodeReader::getHints() const { return m_backend->getHints(); }
+} // namespace sfdm
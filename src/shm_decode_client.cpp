@@ -0,0 +1,109 @@
+#include <sfdm/shm_decode_service.hpp>
+
+#include "shm_ring.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    std::unique_ptr<sfdm::shm::RingMapping> openRing(const std::string &name) {
+        using namespace sfdm::shm;
+        const int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            throw std::runtime_error{"Could not open shared memory " + name + ": " + std::strerror(errno)};
+        }
+        struct stat info {};
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(RingHeader)) {
+            close(fd);
+            throw std::runtime_error{"Shared memory " + name + " is not a decode ring!"};
+        }
+        const auto size = static_cast<size_t>(info.st_size);
+        void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED) {
+            throw std::runtime_error{"Could not map shared memory " + name + ": " + std::strerror(errno)};
+        }
+        auto mapping = std::make_unique<RingMapping>(name, address, size, false);
+        const auto &header = mapping->header();
+        if (header.magic != ringMagic || header.version != ringVersion || header.totalSize != size) {
+            throw std::runtime_error{"Shared memory " + name + " is not a compatible decode ring!"};
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return mapping;
+    }
+
+    sfdm::Point toPoint(const uint32_t *coordinates) { return {coordinates[0], coordinates[1]}; }
+} // namespace
+
+namespace sfdm::shm {
+    ShmDecodeClient::ShmDecodeClient(const std::string &name) : m_mapping{openRing(name)} {}
+
+    ShmDecodeClient::~ShmDecodeClient() = default;
+
+    std::optional<ShmDecodeClient::FrameSlot> ShmDecodeClient::acquireFrame(std::chrono::milliseconds timeout) {
+        auto &header = m_mapping->header();
+        if (!waitFor(header.freeSlots, timeout)) {
+            return std::nullopt;
+        }
+        // the semaphore guarantees, that at least one slot is free
+        while (true) {
+            for (uint32_t i = 0; i < header.slotCount; ++i) {
+                auto expected = static_cast<uint32_t>(SlotState::Free);
+                if (m_mapping->slot(i).state.compare_exchange_strong(
+                            expected, static_cast<uint32_t>(SlotState::Writing), std::memory_order_acq_rel)) {
+                    return FrameSlot{i, m_mapping->frame(i), header.maxFrameBytes};
+                }
+            }
+        }
+    }
+
+    void ShmDecodeClient::submitFrame(const FrameSlot &slot, size_t width, size_t height,
+                                      size_t maximumNumberOfCodesToDetect) {
+        auto &header = m_mapping->header();
+        if (width * height > header.maxFrameBytes) {
+            throw std::runtime_error{"Frame does not fit into the slot!"};
+        }
+        auto &slotHeader = m_mapping->slot(slot.index);
+        slotHeader.width = static_cast<uint32_t>(width);
+        slotHeader.height = static_cast<uint32_t>(height);
+        slotHeader.maximumNumberOfCodes = static_cast<uint32_t>(maximumNumberOfCodesToDetect);
+        slotHeader.sequence = header.nextSequence.fetch_add(1, std::memory_order_relaxed);
+        slotHeader.state.store(static_cast<uint32_t>(SlotState::Submitted), std::memory_order_release);
+        sem_post(&header.submittedSlots);
+    }
+
+    std::optional<std::vector<DecodeResult>> ShmDecodeClient::waitForResults(const FrameSlot &slot,
+                                                                             std::chrono::milliseconds timeout) {
+        auto &slotHeader = m_mapping->slot(slot.index);
+        if (!waitFor(slotHeader.done, timeout)) {
+            return std::nullopt;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        const auto &resultHeader = m_mapping->results(slot.index);
+        if (resultHeader.failed) {
+            releaseFrame(slot);
+            throw std::runtime_error{"Server could not decode the frame!"};
+        }
+        std::vector<DecodeResult> results;
+        results.reserve(resultHeader.count);
+        for (uint32_t i = 0; i < resultHeader.count; ++i) {
+            const auto &record = m_mapping->record(slot.index, i);
+            const CodePosition position{toPoint(record.coordinates), toPoint(record.coordinates + 2),
+                                        toPoint(record.coordinates + 4), toPoint(record.coordinates + 6)};
+            results.emplace_back(std::string{m_mapping->recordText(slot.index, i), record.textLength}, position);
+        }
+        releaseFrame(slot);
+        return results;
+    }
+
+    void ShmDecodeClient::releaseFrame(const FrameSlot &slot) {
+        auto &header = m_mapping->header();
+        m_mapping->slot(slot.index).state.store(static_cast<uint32_t>(SlotState::Free), std::memory_order_release);
+        sem_post(&header.freeSlots);
+    }
+} // namespace sfdm::shm
@@ -0,0 +1,188 @@
+#include <sfdm/shm_decode_service.hpp>
+
+#include "shm_ring.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+    std::unique_ptr<sfdm::shm::RingMapping> createRing(const sfdm::shm::ShmDecodeServerConfig &config) {
+        using namespace sfdm::shm;
+        if (config.slotCount == 0 || config.maxFrameBytes == 0) {
+            throw std::runtime_error{"Ring needs at least one slot and frame byte!"};
+        }
+
+        // frames are page aligned, so that acquisition can write into them like into any other frame buffer
+        const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const auto alignToPage = [&](size_t value) { return (value + pageSize - 1) / pageSize * pageSize; };
+        const size_t slotsOffset = RingMapping::alignUp(sizeof(RingHeader));
+        const size_t framesOffset = alignToPage(slotsOffset + config.slotCount * sizeof(SlotHeader));
+        const size_t frameStride = alignToPage(config.maxFrameBytes);
+        const size_t resultsOffset = framesOffset + config.slotCount * frameStride;
+        const size_t recordStride = RingMapping::alignUp(sizeof(ResultRecord) + config.maxTextLength);
+        const size_t resultStride =
+                RingMapping::alignUp(RingMapping::recordOffset() + config.maxResultsPerFrame * recordStride);
+        const size_t totalSize = resultsOffset + config.slotCount * resultStride;
+
+        shm_unlink(config.name.c_str());
+        const int fd = shm_open(config.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+        if (fd < 0) {
+            throw std::runtime_error{"Could not create shared memory " + config.name + ": " + std::strerror(errno)};
+        }
+        if (ftruncate(fd, static_cast<off_t>(totalSize)) != 0) {
+            close(fd);
+            shm_unlink(config.name.c_str());
+            throw std::runtime_error{"Could not resize shared memory " + config.name + ": " + std::strerror(errno)};
+        }
+        void *address = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED) {
+            shm_unlink(config.name.c_str());
+            throw std::runtime_error{"Could not map shared memory " + config.name + ": " + std::strerror(errno)};
+        }
+        auto mapping = std::make_unique<RingMapping>(config.name, address, totalSize, true);
+
+        auto *header = new (address) RingHeader{};
+        header->magic = ringMagic;
+        header->slotCount = config.slotCount;
+        header->maxResultsPerFrame = config.maxResultsPerFrame;
+        header->maxTextLength = config.maxTextLength;
+        header->maxFrameBytes = config.maxFrameBytes;
+        header->slotsOffset = slotsOffset;
+        header->framesOffset = framesOffset;
+        header->frameStride = frameStride;
+        header->resultsOffset = resultsOffset;
+        header->resultStride = resultStride;
+        header->totalSize = totalSize;
+        sem_init(&header->freeSlots, 1, config.slotCount);
+        sem_init(&header->submittedSlots, 1, 0);
+        for (uint32_t i = 0; i < config.slotCount; ++i) {
+            auto *slot = new (&mapping->slot(i)) SlotHeader{};
+            sem_init(&slot->done, 1, 0);
+        }
+        // the version is written last, clients refuse to attach before the ring is complete
+        std::atomic_thread_fence(std::memory_order_release);
+        header->version = ringVersion;
+        return mapping;
+    }
+
+    // the oldest submitted frame is decoded first
+    std::optional<uint32_t> claimSubmittedSlot(const sfdm::shm::RingMapping &mapping) {
+        using namespace sfdm::shm;
+        while (true) {
+            std::optional<uint32_t> oldest;
+            for (uint32_t i = 0; i < mapping.header().slotCount; ++i) {
+                auto &slot = mapping.slot(i);
+                if (slot.state.load(std::memory_order_acquire) == static_cast<uint32_t>(SlotState::Submitted) &&
+                    (!oldest || slot.sequence < mapping.slot(*oldest).sequence)) {
+                    oldest = i;
+                }
+            }
+            if (!oldest) {
+                return std::nullopt;
+            }
+            auto expected = static_cast<uint32_t>(SlotState::Submitted);
+            if (mapping.slot(*oldest).state.compare_exchange_strong(expected,
+                                                                     static_cast<uint32_t>(SlotState::Decoding),
+                                                                     std::memory_order_acq_rel)) {
+                return oldest;
+            }
+        }
+    }
+
+    void writeResults(const sfdm::shm::RingMapping &mapping, uint32_t index,
+                      const std::vector<sfdm::DecodeResult> &results) {
+        auto &resultHeader = mapping.results(index);
+        const auto count =
+                static_cast<uint32_t>(std::min<size_t>(results.size(), mapping.header().maxResultsPerFrame));
+        resultHeader.truncated = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            const auto &result = results[i];
+            auto &record = mapping.record(index, i);
+            const auto &position = result.position;
+            const uint32_t coordinates[8] = {position.bottomLeft.x,  position.bottomLeft.y, position.topLeft.x,
+                                             position.topLeft.y,     position.topRight.x,   position.topRight.y,
+                                             position.bottomRight.x, position.bottomRight.y};
+            std::copy_n(coordinates, 8, record.coordinates);
+            record.textLength =
+                    static_cast<uint32_t>(std::min<size_t>(result.text.size(), mapping.header().maxTextLength));
+            std::memcpy(mapping.recordText(index, i), result.text.data(), record.textLength);
+            if (record.textLength != result.text.size()) {
+                resultHeader.truncated = 1;
+            }
+        }
+        if (count != results.size()) {
+            resultHeader.truncated = 1;
+        }
+        resultHeader.count = count;
+    }
+} // namespace
+
+namespace sfdm::shm {
+    ShmDecodeServer::ShmDecodeServer(ShmDecodeServerConfig config, const ReaderFactory &readerFactory) :
+        m_config{std::move(config)}, m_mapping{createRing(m_config)} {
+        const auto workerCount = std::max<size_t>(1, m_config.workerCount);
+        m_readers.reserve(workerCount);
+        m_workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; ++i) {
+            m_readers.emplace_back(readerFactory());
+        }
+        for (auto &reader: m_readers) {
+            m_workers.emplace_back([this, &reader](const std::stop_token &stopToken) { work(*reader, stopToken); });
+        }
+    }
+
+    ShmDecodeServer::~ShmDecodeServer() { stop(); }
+
+    void ShmDecodeServer::stop() {
+        for (auto &worker: m_workers) {
+            worker.request_stop();
+        }
+        m_workers.clear();
+        m_mapping.reset();
+    }
+
+    const ShmDecodeServerConfig &ShmDecodeServer::getConfig() const { return m_config; }
+
+    void ShmDecodeServer::work(ICodeReader &reader, const std::stop_token &stopToken) {
+        auto &header = m_mapping->header();
+        auto options = reader.getDefaultOptions();
+        while (!stopToken.stop_requested()) {
+            // wake up regularly to check for the stop request
+            if (!waitFor(header.submittedSlots, std::chrono::milliseconds{50})) {
+                continue;
+            }
+            const auto index = claimSubmittedSlot(*m_mapping);
+            if (!index) {
+                continue;
+            }
+
+            auto &slot = m_mapping->slot(*index);
+            auto &resultHeader = m_mapping->results(*index);
+            try {
+                options.maximumNumberOfCodesToDetect = slot.maximumNumberOfCodes;
+                // the slot is written by another process, its size is checked against the size of the mapping, that
+                // the server created. uint32_t dimensions cannot overflow the 64-bit product.
+                const uint64_t width = slot.width;
+                const uint64_t height = slot.height;
+                if (width == 0 || height == 0 || width * height > m_config.maxFrameBytes) {
+                    throw std::runtime_error{"Frame does not fit into the slot!"};
+                }
+                const ImageView image{static_cast<size_t>(width), static_cast<size_t>(height),
+                                      m_mapping->frame(*index)};
+                writeResults(*m_mapping, *index, reader.decode(image, options));
+                resultHeader.failed = 0;
+            } catch (const std::exception &) {
+                resultHeader.count = 0;
+                resultHeader.failed = 1;
+            }
+            slot.state.store(static_cast<uint32_t>(SlotState::Done), std::memory_order_release);
+            sem_post(&slot.done);
+        }
+    }
+} // namespace sfdm::shm
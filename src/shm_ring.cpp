@@ -0,0 +1,31 @@
+#include "shm_ring.hpp"
+
+#include <cerrno>
+#include <ctime>
+#include <sys/mman.h>
+
+namespace sfdm::shm {
+    RingMapping::~RingMapping() {
+        if (address) {
+            munmap(address, size);
+        }
+        if (owner) {
+            shm_unlink(name.c_str());
+        }
+    }
+
+    bool waitFor(sem_t &semaphore, std::chrono::milliseconds timeout) {
+        timespec deadline{};
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        const auto nanoseconds = deadline.tv_nsec + std::chrono::nanoseconds{timeout}.count();
+        deadline.tv_sec += static_cast<time_t>(nanoseconds / 1'000'000'000);
+        deadline.tv_nsec = static_cast<long>(nanoseconds % 1'000'000'000);
+
+        while (sem_timedwait(&semaphore, &deadline) != 0) {
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace sfdm::shm
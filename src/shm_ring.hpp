@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <semaphore.h>
+#include <string>
+
+namespace sfdm::shm {
+    constexpr uint32_t ringMagic = 0x5346444d; // "SFDM"
+    constexpr uint32_t ringVersion = 1;
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+                  "atomics in shared memory have to be lock free");
+
+    enum class SlotState : uint32_t {
+        Free,
+        Writing,
+        Submitted,
+        Decoding,
+        Done,
+    };
+
+    struct RingHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t maxResultsPerFrame;
+        uint32_t maxTextLength;
+        uint64_t maxFrameBytes;
+        uint64_t slotsOffset;
+        uint64_t framesOffset;
+        uint64_t frameStride;
+        uint64_t resultsOffset;
+        uint64_t resultStride;
+        uint64_t totalSize;
+        std::atomic<uint64_t> nextSequence;
+        sem_t freeSlots;
+        sem_t submittedSlots;
+    };
+
+    struct SlotHeader {
+        std::atomic<uint32_t> state;
+        uint32_t width;
+        uint32_t height;
+        uint32_t maximumNumberOfCodes;
+        uint64_t sequence;
+        sem_t done;
+    };
+
+    struct ResultHeader {
+        uint32_t count;
+        uint32_t truncated;
+        uint32_t failed;
+    };
+
+    // followed by maxTextLength bytes of text
+    struct ResultRecord {
+        uint32_t coordinates[8];
+        uint32_t textLength;
+    };
+
+    /*!
+     * Owns the mapping of the shared memory ring and computes the addresses of its parts.
+     * The layout is: RingHeader | SlotHeader[slotCount] | frames[slotCount] | results[slotCount]
+     */
+    struct RingMapping {
+        std::string name;
+        void *address{};
+        size_t size{};
+        bool owner{};
+
+        RingMapping(std::string name, void *address, size_t size, bool owner) :
+            name{std::move(name)}, address{address}, size{size}, owner{owner} {}
+        ~RingMapping();
+        RingMapping(const RingMapping &) = delete;
+        RingMapping &operator=(const RingMapping &) = delete;
+
+        [[nodiscard]] RingHeader &header() const { return *static_cast<RingHeader *>(address); }
+        [[nodiscard]] std::byte *bytes() const { return static_cast<std::byte *>(address); }
+
+        [[nodiscard]] SlotHeader &slot(uint32_t index) const {
+            return reinterpret_cast<SlotHeader *>(bytes() + header().slotsOffset)[index];
+        }
+        [[nodiscard]] uint8_t *frame(uint32_t index) const {
+            return reinterpret_cast<uint8_t *>(bytes() + header().framesOffset + index * header().frameStride);
+        }
+        [[nodiscard]] ResultHeader &results(uint32_t index) const {
+            return *reinterpret_cast<ResultHeader *>(bytes() + header().resultsOffset + index * header().resultStride);
+        }
+        [[nodiscard]] ResultRecord &record(uint32_t index, uint32_t recordIndex) const {
+            auto *first = reinterpret_cast<std::byte *>(&results(index)) + recordOffset();
+            return *reinterpret_cast<ResultRecord *>(first + recordIndex * recordStride());
+        }
+        [[nodiscard]] char *recordText(uint32_t index, uint32_t recordIndex) const {
+            return reinterpret_cast<char *>(&record(index, recordIndex)) + sizeof(ResultRecord);
+        }
+
+        [[nodiscard]] static size_t alignUp(size_t value) { return (value + 63) & ~size_t{63}; }
+        [[nodiscard]] static size_t recordOffset() { return alignUp(sizeof(ResultHeader)); }
+        [[nodiscard]] size_t recordStride() const {
+            return alignUp(sizeof(ResultRecord) + header().maxTextLength);
+        }
+    };
+
+    /*!
+     * sem_timedwait, that retries on interrupts.
+     * @return true, if the semaphore was acquired
+     */
+    bool waitFor(sem_t &semaphore, std::chrono::milliseconds timeout);
+} // namespace sfdm::shm
@@ -0,0 +1,104 @@
+#pragma once
+#include <sfdm/decode_options.hpp>
+#include <sfdm/expected_payloads.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sfdm::detail {
+    /*!
+     * Decides when a decode call has found enough codes. Without expected payloads every code counts. With expected
+     * payloads only codes matching a not yet found item count, and the search stops once all items were found.
+     * Items may overlap, e.g. a pattern and a text matching it, so the counted codes are matched to the items as a
+     * bipartite matching: a code, that only matches taken items, moves the codes holding them to other items if
+     * possible.
+     */
+    class StopCondition {
+    public:
+        explicit StopCondition(const DecodeOptions &options) :
+            m_expectedPayloads{options.expectedPayloads.get()},
+            m_maximumNumberOfCodesToDetect{options.maximumNumberOfCodesToDetect} {
+            if (m_expectedPayloads) {
+                m_itemCodes.resize(m_expectedPayloads->size(), noCode);
+            }
+        }
+
+        /*!
+         * Registers a decoded code.
+         * @return whether the code counts towards the stop condition
+         */
+        bool add(std::string_view text) {
+            if (!m_expectedPayloads) {
+                ++m_count;
+                return true;
+            }
+            m_codes.emplace_back(text);
+            std::vector<bool> visited(m_itemCodes.size());
+            if (!assign(m_codes.size() - 1, visited)) {
+                m_codes.pop_back();
+                return false;
+            }
+            ++m_count;
+            return true;
+        }
+
+        /*!
+         * Replaces the text of a registered code, e.g. when another backend decoded it differently.
+         */
+        void replace(std::string_view oldText, std::string_view newText) {
+            if (!m_expectedPayloads) {
+                return;
+            }
+            for (size_t code = 0; code < m_codes.size(); ++code) {
+                if (m_codes[code] == oldText) {
+                    remove(code);
+                    break;
+                }
+            }
+            add(newText);
+        }
+
+        [[nodiscard]] bool isReached() const {
+            return m_count >= m_maximumNumberOfCodesToDetect ||
+                   (m_expectedPayloads && m_count == m_expectedPayloads->size());
+        }
+
+    private:
+        static constexpr size_t noCode = static_cast<size_t>(-1);
+
+        // augmenting path search: assigns the code to a free item or moves the code of a taken item elsewhere
+        bool assign(size_t code, std::vector<bool> &visited) {
+            for (size_t i = 0; i < m_itemCodes.size(); ++i) {
+                if (visited[i] || !m_expectedPayloads->matches(i, m_codes[code])) {
+                    continue;
+                }
+                visited[i] = true;
+                if (m_itemCodes[i] == noCode || assign(m_itemCodes[i], visited)) {
+                    m_itemCodes[i] = code;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // every code holds exactly one item, so the remaining codes stay assigned
+        void remove(size_t code) {
+            m_codes.erase(m_codes.begin() + static_cast<std::ptrdiff_t>(code));
+            for (auto &itemCode: m_itemCodes) {
+                if (itemCode == code) {
+                    itemCode = noCode;
+                } else if (itemCode != noCode && itemCode > code) {
+                    --itemCode;
+                }
+            }
+            --m_count;
+        }
+
+        const ExpectedPayloads *m_expectedPayloads;
+        size_t m_maximumNumberOfCodesToDetect;
+        size_t m_count{};
+        // texts of the counted codes and the code assigned to each expected item
+        std::vector<std::string> m_codes;
+        std::vector<size_t> m_itemCodes;
+    };
+} // namespace sfdm::detail
@@ -0,0 +1,143 @@
+#include <sfdm/stream_decoder.hpp>
+
+#include "bounded_mpmc_queue.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    template<typename T>
+    void updateMaximum(std::atomic<T> &maximum, T value) {
+        auto current = maximum.load(std::memory_order_relaxed);
+        while (current < value && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+} // namespace
+
+namespace sfdm {
+    struct QueuedFrame {
+        uint64_t sequence{};
+        StreamFrame frame;
+    };
+
+    struct StreamFrameQueue {
+        explicit StreamFrameQueue(size_t capacity) : frames{capacity} {}
+        detail::BoundedMpmcQueue<QueuedFrame> frames;
+    };
+
+    StreamDecoder::StreamDecoder(const ICodeReader &reader, StreamDecoderConfig config, DecodeOptions options,
+                                 ResultCallback callback) :
+        m_reader{reader}, m_config{config}, m_options{std::move(options)}, m_callback{std::move(callback)} {
+        if (m_config.workerCount == 0) {
+            throw std::runtime_error{"Stream decoder needs at least one worker!"};
+        }
+        if (m_config.policy == OverloadPolicy::LatestOnly) {
+            m_config.queueCapacity = 1;
+        }
+        m_queue = std::make_unique<StreamFrameQueue>(m_config.queueCapacity);
+
+        m_workers.reserve(m_config.workerCount);
+        for (size_t i = 0; i < m_config.workerCount; ++i) {
+            m_workers.emplace_back([this] { work(); });
+        }
+    }
+
+    StreamDecoder::~StreamDecoder() { close(); }
+
+    bool StreamDecoder::submit(StreamFrame frame) {
+        if (m_closed) {
+            return false;
+        }
+        if (frame.pixels.size() < frame.width * frame.height) {
+            throw std::runtime_error{"Frame has fewer pixels than width * height!"};
+        }
+
+        QueuedFrame queued{m_nextSequence.fetch_add(1, std::memory_order_relaxed), std::move(frame)};
+        ++m_submittedFrames;
+        while (!m_queue->frames.tryPush(queued)) {
+            if (m_config.policy == OverloadPolicy::DropNewest) {
+                ++m_droppedFrames;
+                return false;
+            }
+            // a worker can take the oldest frame in between, then the next push succeeds without dropping
+            if (m_queue->frames.tryPop()) {
+                ++m_droppedFrames;
+            }
+        }
+        updateMaximum(m_maximumQueueDepth, m_queue->frames.size());
+        m_framesAvailable.release();
+        return true;
+    }
+
+    void StreamDecoder::close() {
+        if (m_closed.exchange(true)) {
+            return;
+        }
+        // every worker needs one more permit to notice, that the queue is drained
+        m_framesAvailable.release(static_cast<std::ptrdiff_t>(m_workers.size()));
+        m_workers.clear();
+    }
+
+    void StreamDecoder::work() {
+        while (true) {
+            m_framesAvailable.acquire();
+            auto queued = m_queue->frames.tryPop();
+            if (!queued) {
+                if (m_closed) {
+                    return;
+                }
+                continue;
+            }
+
+            auto &frame = queued->frame;
+            StreamResult result{queued->sequence, {}, frame.captureTime, {}, {}};
+            const ImageView image{frame.width, frame.height, frame.pixels.data()};
+            try {
+                if (m_config.maximumLatency.count() > 0) {
+                    const auto deadline = frame.captureTime + m_config.maximumLatency;
+                    if (std::chrono::steady_clock::now() >= deadline) {
+                        ++m_expiredFrames;
+                        continue;
+                    }
+                    auto options = m_options;
+                    options.deadline = options.deadline ? std::min(*options.deadline, deadline) : deadline;
+                    result.results = m_reader.decode(image, options);
+                } else {
+                    result.results = m_reader.decode(image, m_options);
+                }
+            } catch (const std::exception &e) {
+                result.error = e.what();
+            }
+            result.latency = std::chrono::steady_clock::now() - frame.captureTime;
+            recordLatency(result.latency);
+            ++m_decodedFrames;
+            if (m_callback) {
+                m_callback(std::move(result));
+            }
+        }
+    }
+
+    void StreamDecoder::recordLatency(std::chrono::nanoseconds latency) {
+        const auto nanoseconds = static_cast<int64_t>(latency.count());
+        m_lastLatency = nanoseconds;
+        m_latencySum += nanoseconds;
+        updateMaximum(m_maximumLatency, nanoseconds);
+    }
+
+    StreamStatistics StreamDecoder::getStatistics() const {
+        StreamStatistics statistics;
+        statistics.queueDepth = m_queue->frames.size();
+        statistics.maximumQueueDepth = m_maximumQueueDepth;
+        statistics.submittedFrames = m_submittedFrames;
+        statistics.decodedFrames = m_decodedFrames;
+        statistics.droppedFrames = m_droppedFrames;
+        statistics.expiredFrames = m_expiredFrames;
+        statistics.lastLatency = std::chrono::nanoseconds{m_lastLatency.load()};
+        statistics.maximumLatency = std::chrono::nanoseconds{m_maximumLatency.load()};
+        if (statistics.decodedFrames > 0) {
+            statistics.meanLatency =
+                    std::chrono::nanoseconds{m_latencySum.load() / static_cast<int64_t>(statistics.decodedFrames)};
+        }
+        return statistics;
+    }
+} // namespace sfdm
@@ -0,0 +1,84 @@
+#include <sfdm/strip_decoder.hpp>
+
+#include "code_position_utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace sfdm {
+    StripDecoder::StripDecoder(const ICodeReader &reader, StripDecoderConfig config, DecodeOptions options) :
+        m_reader{reader}, m_config{config}, m_options{std::move(options)} {
+        if (m_config.width == 0 || m_config.stripHeight == 0) {
+            throw std::runtime_error{"Strip width and height must not be 0!"};
+        }
+        if (m_config.overlap >= m_config.stripHeight) {
+            throw std::runtime_error{"Strip overlap has to be smaller than the strip height!"};
+        }
+        m_strip.resize(m_config.width * m_config.stripHeight);
+        // positions in a strip say nothing about where codes are in the frame
+        m_options.locationPrior.reset();
+    }
+
+    std::vector<DecodeResult> StripDecoder::push(const uint8_t *rows, size_t rowCount) {
+        std::vector<DecodeResult> results;
+        while (rowCount > 0) {
+            const auto count = std::min(rowCount, m_config.stripHeight - m_bufferedRows);
+            std::memcpy(m_strip.data() + m_bufferedRows * m_config.width, rows, count * m_config.width);
+            m_bufferedRows += count;
+            rows += count * m_config.width;
+            rowCount -= count;
+
+            if (m_bufferedRows == m_config.stripHeight) {
+                auto stripResults = decodeStrip(m_bufferedRows);
+                results.insert(results.end(), std::make_move_iterator(stripResults.begin()),
+                               std::make_move_iterator(stripResults.end()));
+
+                // the overlap becomes the top of the next strip
+                const auto advance = m_config.stripHeight - m_config.overlap;
+                std::memmove(m_strip.data(), m_strip.data() + advance * m_config.width,
+                             m_config.overlap * m_config.width);
+                m_stripTop += advance;
+                m_bufferedRows = m_config.overlap;
+                m_decodedRows = m_config.overlap;
+            }
+        }
+        return results;
+    }
+
+    std::vector<DecodeResult> StripDecoder::finish() {
+        std::vector<DecodeResult> results;
+        if (m_bufferedRows > m_decodedRows) {
+            results = decodeStrip(m_bufferedRows);
+        }
+        m_stripTop = 0;
+        m_bufferedRows = 0;
+        m_decodedRows = 0;
+        m_overlapResults.clear();
+        return results;
+    }
+
+    size_t StripDecoder::getRowCount() const { return m_stripTop + m_bufferedRows; }
+
+    std::vector<DecodeResult> StripDecoder::decodeStrip(size_t rowCount) {
+        auto stripResults = m_reader.decode(ImageView{m_config.width, rowCount, m_strip.data()}, m_options);
+
+        std::vector<DecodeResult> newResults;
+        std::vector<DecodeResult> overlapResults;
+        const auto nextStripTop = m_stripTop + m_config.stripHeight - m_config.overlap;
+        for (auto &result: stripResults) {
+            result.position = detail::translate(result.position, 0, static_cast<uint32_t>(m_stripTop));
+            if (detail::bounds(result.position).bottom > nextStripTop) {
+                overlapResults.push_back(result);
+            }
+            const bool isDuplicate = std::ranges::any_of(m_overlapResults, [&](const DecodeResult &previous) {
+                return detail::isSameCode(previous, result);
+            });
+            if (!isDuplicate) {
+                newResults.emplace_back(std::move(result));
+            }
+        }
+        m_overlapResults = std::move(overlapResults);
+        return newResults;
+    }
+} // namespace sfdm
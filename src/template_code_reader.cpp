@@ -0,0 +1,146 @@
+#include <sfdm/template_code_reader.hpp>
+
+#include "code_position_utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    uint64_t squaredDistance(const sfdm::Point &p1, const sfdm::Point &p2) {
+        const auto dx = static_cast<int64_t>(p1.x) - static_cast<int64_t>(p2.x);
+        const auto dy = static_cast<int64_t>(p1.y) - static_cast<int64_t>(p2.y);
+        return static_cast<uint64_t>(dx * dx + dy * dy);
+    }
+
+    uint32_t height(const sfdm::CodePosition &position) {
+        const auto [minY, maxY] = std::minmax(
+                {position.bottomLeft.y, position.topLeft.y, position.topRight.y, position.bottomRight.y});
+        return maxY - minY;
+    }
+} // namespace
+
+namespace sfdm {
+    CodeLayout CodeLayout::fromCalibration(const std::vector<DecodeResult> &results, uint32_t tolerance) {
+        std::vector<CodePosition> positions;
+        positions.reserve(results.size());
+        std::ranges::transform(results, std::back_inserter(positions), &DecodeResult::position);
+        std::ranges::sort(positions, {}, [](const CodePosition &position) { return detail::center(position).y; });
+
+        // codes whose centers are less than half a code apart vertically belong to the same row
+        CodeLayout layout;
+        layout.slots.reserve(positions.size());
+        auto rowBegin = positions.begin();
+        while (rowBegin != positions.end()) {
+            const auto rowY = detail::center(*rowBegin).y;
+            const auto rowEnd = std::find_if(rowBegin, positions.end(), [&](const CodePosition &position) {
+                return detail::center(position).y - rowY > height(*rowBegin) / 2;
+            });
+            std::sort(rowBegin, rowEnd, [](const CodePosition &lhs, const CodePosition &rhs) {
+                return detail::center(lhs).x < detail::center(rhs).x;
+            });
+            std::transform(rowBegin, rowEnd, std::back_inserter(layout.slots),
+                           [&](const CodePosition &position) { return CodeSlot{position, tolerance}; });
+            rowBegin = rowEnd;
+        }
+        return layout;
+    }
+
+    TemplateCodeReader::TemplateCodeReader(std::unique_ptr<ICodeReader> backend, CodeLayout layout,
+                                           size_t threadCount) :
+        m_backend{std::move(backend)}, m_layout{std::move(layout)},
+        m_threadCount{threadCount ? threadCount : std::max(1U, std::thread::hardware_concurrency())} {
+        if (!m_backend) {
+            throw std::runtime_error{"Template code reader needs a backend!"};
+        }
+    }
+
+    std::optional<DecodeResult> TemplateCodeReader::decodeSlot(const ImageView &image, const CodeSlot &slot,
+                                                               const DecodeOptions &options) const {
+        const auto roi = detail::boundingBox(slot.expectedPosition, slot.tolerance, image);
+        if (roi.width() == 0 || roi.height() == 0) {
+            return std::nullopt;
+        }
+
+        // ImageView has no row stride, so the region of interest is copied. It is small compared to the image.
+        std::vector<uint8_t> roiPixels(static_cast<size_t>(roi.width()) * roi.height());
+        for (uint32_t y = 0; y < roi.height(); ++y) {
+            const auto *row = image.data + (roi.top + y) * image.width + roi.left;
+            std::copy_n(row, roi.width(), roiPixels.data() + static_cast<size_t>(y) * roi.width());
+        }
+
+        auto results = m_backend->decode(ImageView{roi.width(), roi.height(), roiPixels.data()}, options);
+        if (results.empty()) {
+            return std::nullopt;
+        }
+
+        const auto expectedCenter = detail::center(slot.expectedPosition);
+        auto best = std::ranges::min_element(results, {}, [&](const DecodeResult &result) {
+            return squaredDistance(detail::center(result.position),
+                                   Point{expectedCenter.x - roi.left, expectedCenter.y - roi.top});
+        });
+        best->position = detail::translate(best->position, roi.left, roi.top);
+        return std::move(*best);
+    }
+
+    std::vector<SlotResult> TemplateCodeReader::decodeSlots(const ImageView &image) const {
+        return decodeSlots(image, m_backend->getDefaultOptions());
+    }
+
+    std::vector<SlotResult> TemplateCodeReader::decodeSlots(const ImageView &image,
+                                                            const DecodeOptions &options) const {
+        auto slotOptions = options;
+        slotOptions.maximumNumberOfCodesToDetect = 1;
+        // the slots are the locations already
+        slotOptions.locationPrior.reset();
+
+        const auto &slots = m_layout.slots;
+        std::vector<SlotResult> results(slots.size());
+        std::atomic<size_t> nextSlot = 0;
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        const auto work = [&] {
+            try {
+                for (size_t i = nextSlot++; i < slots.size(); i = nextSlot++) {
+                    results[i] = {i, decodeSlot(image, slots[i], slotOptions)};
+                }
+            } catch (...) {
+                std::lock_guard lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                // the remaining slots are not started
+                nextSlot = slots.size();
+            }
+        };
+
+        const auto threadCount = std::min(m_threadCount, slots.size());
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(threadCount > 0 ? threadCount - 1 : 0);
+            for (size_t i = 1; i < threadCount; ++i) {
+                threads.emplace_back(work);
+            }
+            work();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return results;
+    }
+
+    std::vector<DecodeResult> TemplateCodeReader::decode(const ImageView &image) const {
+        std::vector<DecodeResult> results;
+        for (auto &slotResult: decodeSlots(image)) {
+            if (slotResult.result) {
+                results.emplace_back(std::move(*slotResult.result));
+            }
+        }
+        return results;
+    }
+
+    const CodeLayout &TemplateCodeReader::getLayout() const { return m_layout; }
+} // namespace sfdm
@@ -0,0 +1,330 @@
+#include <sfdm/code_location_prior.hpp>
+#include <sfdm/variant_racing_code_reader.hpp>
+
+#include "code_position_utils.hpp"
+#include "quality_gate_utils.hpp"
+#include "stop_condition.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+
+namespace {
+    using sfdm::ImageVariant;
+
+    bool isInverted(ImageVariant variant) {
+        return variant == ImageVariant::Inverted || variant == ImageVariant::InvertedMirrored;
+    }
+
+    bool isMirrored(ImageVariant variant) {
+        return variant == ImageVariant::Mirrored || variant == ImageVariant::InvertedMirrored;
+    }
+
+    sfdm::Point mirror(const sfdm::Point &point, size_t width) {
+        return {static_cast<uint32_t>(width - 1 - point.x), point.y};
+    }
+
+    struct VariantDetectionState : sfdm::detail::DetectionState {
+        VariantDetectionState(ImageVariant variant, sfdm::DetectionResult detection) :
+            variant{variant}, detection{std::move(detection)} {}
+        ImageVariant variant;
+        // position in the variant, as needed by the backend
+        sfdm::DetectionResult detection;
+    };
+
+    // pixels of the largest copy a variant holds, the normal variant needs none
+    size_t variantCopyBytes(const std::vector<ImageVariant> &variants, const sfdm::ImageView &image) {
+        const bool copies = std::ranges::any_of(variants, [](ImageVariant variant) {
+            return variant != ImageVariant::Normal;
+        });
+        return copies ? image.width * image.height : 0;
+    }
+
+    /*!
+     * Runs decodeVariant for every variant on its own thread, the first variant on the calling thread. Results are
+     * mapped back onto the image and merged, until the stop condition of the options is reached.
+     * @param serialized decode the variants one after another on the calling thread instead
+     */
+    template<typename Result, typename DecodeVariant>
+    std::vector<Result> race(const std::vector<ImageVariant> &variants, const sfdm::ImageView &image,
+                             const sfdm::DecodeOptions &options, bool serialized, const DecodeVariant &decodeVariant) {
+        std::vector<Result> results;
+        sfdm::detail::StopCondition stopCondition(options);
+        std::exception_ptr error;
+        std::mutex resultsMutex;
+
+        // a stop requested by the caller stops all variants
+        std::stop_source stopSource;
+        const std::stop_callback forwardStop(options.stopToken, [&] { stopSource.request_stop(); });
+        auto variantOptions = options;
+        variantOptions.stopToken = stopSource.get_token();
+        // every variant would observe the frame, the caller feeds the merged results into the prior once instead
+        variantOptions.locationPrior.reset();
+
+        const auto run = [&](ImageVariant variant) {
+            try {
+                std::vector<uint8_t> pixels;
+                const auto variantImage = sfdm::createImageVariant(image, variant, pixels);
+                if (stopSource.stop_requested()) {
+                    return;
+                }
+                auto variantResults = decodeVariant(variantImage, variant, variantOptions);
+
+                std::lock_guard lock(resultsMutex);
+                for (auto &result: variantResults) {
+                    if (stopCondition.isReached()) {
+                        break;
+                    }
+                    result.position = sfdm::toOriginalPosition(result.position, variant, image);
+                    const bool isDuplicate = std::ranges::any_of(results, [&](const Result &found) {
+                        return sfdm::detail::diagonallyOppositeMatch(found.position, result.position);
+                    });
+                    if (isDuplicate) {
+                        continue;
+                    }
+                    if constexpr (std::is_same_v<Result, sfdm::DecodeResult>) {
+                        stopCondition.add(result.text);
+                    } else {
+                        stopCondition.add({});
+                    }
+                    results.emplace_back(std::move(result));
+                }
+                if (stopCondition.isReached()) {
+                    stopSource.request_stop();
+                }
+            } catch (...) {
+                std::lock_guard lock(resultsMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                stopSource.request_stop();
+            }
+        };
+
+        if (serialized) {
+            for (const auto variant: variants) {
+                if (stopSource.stop_requested()) {
+                    break;
+                }
+                run(variant);
+            }
+        } else {
+            std::vector<std::jthread> threads;
+            threads.reserve(variants.size() - 1);
+            for (size_t i = 1; i < variants.size(); ++i) {
+                threads.emplace_back(run, variants[i]);
+            }
+            run(variants.front());
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return results;
+    }
+} // namespace
+
+namespace sfdm {
+    ImageView createImageVariant(const ImageView &image, ImageVariant variant, std::vector<uint8_t> &pixels) {
+        if (variant == ImageVariant::Normal) {
+            return image;
+        }
+        pixels.resize(image.width * image.height);
+        // xor with 0xff inverts, the row loops are simple enough to be vectorized by the compiler
+        const uint8_t mask = isInverted(variant) ? 0xff : 0x00;
+        for (size_t y = 0; y < image.height; ++y) {
+            const uint8_t *in = image.data + y * image.width;
+            uint8_t *out = pixels.data() + y * image.width;
+            if (isMirrored(variant)) {
+                for (size_t x = 0; x < image.width; ++x) {
+                    out[x] = in[image.width - 1 - x] ^ mask;
+                }
+            } else {
+                for (size_t x = 0; x < image.width; ++x) {
+                    out[x] = in[x] ^ mask;
+                }
+            }
+        }
+        return {image.width, image.height, pixels.data()};
+    }
+
+    CodePosition toOriginalPosition(const CodePosition &position, ImageVariant variant, const ImageView &image) {
+        if (!isMirrored(variant)) {
+            return position;
+        }
+        // the corners keep their labels, a mirrored code read in the mirrored image is a regular code
+        return {mirror(position.bottomLeft, image.width), mirror(position.topLeft, image.width),
+                mirror(position.topRight, image.width), mirror(position.bottomRight, image.width)};
+    }
+
+    VariantRacingCodeReader::VariantRacingCodeReader(std::unique_ptr<ICodeReader> backend,
+                                                     std::vector<ImageVariant> variants) :
+        m_backend{std::move(backend)}, m_variants{std::move(variants)} {
+        if (!m_backend) {
+            throw std::runtime_error{"Variant racing code reader needs a backend!"};
+        }
+        if (m_variants.empty()) {
+            throw std::runtime_error{"Variant racing code reader needs at least one variant!"};
+        }
+    }
+
+    std::vector<DecodeResult> VariantRacingCodeReader::decode(const ImageView &image,
+                                                              const DecodeOptions &options) const {
+        // measured once here, the variants have the same contrast and sharpness
+        if (options.qualityGate) {
+            return detail::withQualityGate(image, options, [&](const DecodeOptions &gatedOptions) {
+                return decode(image, gatedOptions);
+            });
+        }
+        auto raceOptions = options;
+        bool serialized = false;
+        if (options.memoryLimit) {
+            const auto usage = estimateMemoryUsage(image, options);
+            if (!usage.withinLimit) {
+                return {};
+            }
+            serialized = usage.serialized;
+            if (serialized) {
+                // the copy of the current variant is taken from the limit of the backend
+                raceOptions.memoryLimit = *options.memoryLimit - variantCopyBytes(m_variants, image);
+            }
+        }
+        auto results = race<DecodeResult>(
+                m_variants, image, raceOptions, serialized,
+                [&](const ImageView &variantImage, ImageVariant, const DecodeOptions &variantOptions) {
+                    return m_backend->decode(variantImage, variantOptions);
+                });
+        if (options.locationPrior) {
+            std::vector<CodePosition> positions;
+            positions.reserve(results.size());
+            std::ranges::transform(results, std::back_inserter(positions), &DecodeResult::position);
+            options.locationPrior->observe(image, positions);
+        }
+        return results;
+    }
+
+    std::vector<DecodeResult> VariantRacingCodeReader::decode(const ImageView &image, const DecodeOptions &options,
+                                                              std::function<void(DecodeResult)> callback) const {
+        auto results = decode(image, options);
+        if (callback) {
+            for (const auto &result: results) {
+                callback(result);
+            }
+        }
+        return results;
+    }
+
+    std::vector<DetectionResult> VariantRacingCodeReader::detect(const ImageView &image,
+                                                                 const DecodeOptions &options) const {
+        if (options.qualityGate) {
+            return detail::withQualityGate(image, options, [&](const DecodeOptions &gatedOptions) {
+                return detect(image, gatedOptions);
+            });
+        }
+        auto detectOptions = options;
+        detectOptions.expectedPayloads.reset();
+        return race<DetectionResult>(
+                m_variants, image, detectOptions, false,
+                [&](const ImageView &variantImage, ImageVariant variant, const DecodeOptions &variantOptions) {
+                    auto detections = m_backend->detect(variantImage, variantOptions);
+                    for (auto &detection: detections) {
+                        detection.state = std::make_shared<VariantDetectionState>(variant, detection);
+                    }
+                    return detections;
+                });
+    }
+
+    std::optional<DecodeResult> VariantRacingCodeReader::decode(const ImageView &image,
+                                                                const DetectionResult &detection,
+                                                                const DecodeOptions &options) const {
+        std::vector<uint8_t> pixels;
+        if (const auto *state = dynamic_cast<const VariantDetectionState *>(detection.state.get())) {
+            auto result = m_backend->decode(createImageVariant(image, state->variant, pixels), state->detection,
+                                             options);
+            if (result) {
+                result->position = toOriginalPosition(result->position, state->variant, image);
+            }
+            return result;
+        }
+
+        // positions without state are tried in one variant after the other, mirroring maps them onto the variant
+        for (const auto variant: m_variants) {
+            const DetectionResult variantDetection{toOriginalPosition(detection.position, variant, image), nullptr};
+            auto result = m_backend->decode(createImageVariant(image, variant, pixels), variantDetection, options);
+            if (result) {
+                result->position = toOriginalPosition(result->position, variant, image);
+                return result;
+            }
+            if (options.shouldStop()) {
+                break;
+            }
+        }
+        return std::nullopt;
+    }
+
+    MemoryUsage VariantRacingCodeReader::estimateMemoryUsage(const ImageView &image,
+                                                             const DecodeOptions &options) const {
+        const auto copyBytes = variantCopyBytes(m_variants, image);
+        const auto copyCount = static_cast<size_t>(std::ranges::count_if(m_variants, [](ImageVariant variant) {
+            return variant != ImageVariant::Normal;
+        }));
+        const auto variantCount = m_variants.size();
+        auto unlimitedOptions = options;
+        unlimitedOptions.memoryLimit.reset();
+        const auto backendUsage = m_backend->estimateMemoryUsage(image, unlimitedOptions);
+
+        MemoryUsage usage;
+        const auto concurrentPeak = variantCount * backendUsage.peak + copyCount * copyBytes;
+        if (!options.memoryLimit || concurrentPeak <= *options.memoryLimit) {
+            usage.libdmtxCache = variantCount * backendUsage.libdmtxCache;
+            usage.zxingBuffers = variantCount * backendUsage.zxingBuffers;
+            usage.imageCopies = variantCount * backendUsage.imageCopies + copyCount * copyBytes;
+            usage.callbackThreads = variantCount * backendUsage.callbackThreads;
+            usage.peak = concurrentPeak;
+            return usage;
+        }
+
+        // one variant after the other, the backend gets what the copy of the variant leaves
+        usage.serialized = true;
+        if (*options.memoryLimit <= copyBytes) {
+            usage.withinLimit = false;
+            return usage;
+        }
+        auto backendOptions = options;
+        backendOptions.memoryLimit = *options.memoryLimit - copyBytes;
+        const auto serialUsage = m_backend->estimateMemoryUsage(image, backendOptions);
+        usage.libdmtxCache = serialUsage.libdmtxCache;
+        usage.zxingBuffers = serialUsage.zxingBuffers;
+        usage.imageCopies = serialUsage.imageCopies + copyBytes;
+        usage.callbackThreads = serialUsage.callbackThreads;
+        usage.peak = serialUsage.peak + copyBytes;
+        usage.striped = serialUsage.striped;
+        usage.downscaled = serialUsage.downscaled;
+        usage.withinLimit = serialUsage.withinLimit;
+        return usage;
+    }
+
+    const DecodeOptions &VariantRacingCodeReader::getDefaultOptions() const { return m_backend->getDefaultOptions(); }
+
+    void VariantRacingCodeReader::setTimeout(uint32_t msec) { m_backend->setTimeout(msec); }
+    uint32_t VariantRacingCodeReader::getTimeout() const { return m_backend->getTimeout(); }
+    bool VariantRacingCodeReader::isTimeoutSupported() { return m_backend->isTimeoutSupported(); }
+
+    void VariantRacingCodeReader::setMaximumNumberOfCodesToDetect(size_t count) {
+        m_backend->setMaximumNumberOfCodesToDetect(count);
+    }
+    size_t VariantRacingCodeReader::getMaximumNumberOfCodesToDetect() const {
+        return m_backend->getMaximumNumberOfCodesToDetect();
+    }
+
+    bool VariantRacingCodeReader::isDecodeWithCallbackSupported() { return true; }
+
+    void VariantRacingCodeReader::setHints(const DecodeHints &hints) { m_backend->setHints(hints); }
+    const DecodeHints &VariantRacingCodeReader::getHints() const { return m_backend->getHints(); }
+
+    const std::vector<ImageVariant> &VariantRacingCodeReader::getVariants() const { return m_variants; }
+} // namespace sfdm
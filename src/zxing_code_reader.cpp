@@ -1,59 +1,268 @@
 #include <ZXing/ReadBarcode.h>
 #include <sfdm/zxing_code_reader.hpp>
 
+#include "code_position_utils.hpp"
+#include "decode_hints_utils.hpp"
+#include "memory_plan.hpp"
+#include "quality_gate_utils.hpp"
+#include "stop_condition.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    ZXing::ImageView toZXingImageView(const sfdm::ImageView &image) {
+        return {image.data, static_cast<int>(image.width), static_cast<int>(image.height), ZXing::ImageFormat::Lum};
+    }
+
+    sfdm::CodePosition toCodePosition(const ZXing::Position &zXingPosition) {
+        const auto topLeft = zXingPosition.topLeft();
+        const auto topRight = zXingPosition.topRight();
+        const auto bottomLeft = zXingPosition.bottomLeft();
+        const auto bottomRight = zXingPosition.bottomRight();
+        return {{
+                        static_cast<uint32_t>(bottomLeft.x),
+                        static_cast<uint32_t>(bottomLeft.y),
+                },
+                {
+                        static_cast<uint32_t>(topLeft.x),
+                        static_cast<uint32_t>(topLeft.y),
+                },
+                {
+                        static_cast<uint32_t>(topRight.x),
+                        static_cast<uint32_t>(topRight.y),
+                },
+                {
+                        static_cast<uint32_t>(bottomRight.x),
+                        static_cast<uint32_t>(bottomRight.y),
+                }};
+    }
+
+    ZXing::Binarizer toZXingBinarizer(sfdm::ZXingBinarizer binarizer) {
+        switch (binarizer) {
+            case sfdm::ZXingBinarizer::LocalAverage:
+                return ZXing::Binarizer::LocalAverage;
+            case sfdm::ZXingBinarizer::GlobalHistogram:
+                return ZXing::Binarizer::GlobalHistogram;
+            case sfdm::ZXingBinarizer::FixedThreshold:
+                return ZXing::Binarizer::FixedThreshold;
+            case sfdm::ZXingBinarizer::BoolCast:
+                return ZXing::Binarizer::BoolCast;
+        }
+        throw std::runtime_error{"Unknown binarizer!"};
+    }
+
+    struct ZXingDetectionState : sfdm::detail::DetectionState {
+        explicit ZXingDetectionState(std::string text) : text{std::move(text)} {}
+        std::string text;
+    };
+
+    uint8_t toMaxNumberOfSymbols(size_t count) {
+        if (count > 255) {
+            throw std::runtime_error{"maximum number of codes cannot exceed 255!"};
+        }
+        return static_cast<uint8_t>(count);
+    }
+} // namespace
+
 namespace sfdm {
     struct ZXingCodeReaderImpl {
         ZXing::ReaderOptions options;
+        std::vector<ZXingEffortLevel> effortLadder{ZXingEffortLevel{}};
+        DecodeOptions defaultOptions;
+
+        [[nodiscard]] ZXing::ReaderOptions optionsFor(const ZXingEffortLevel &level,
+                                                      const DecodeOptions &decodeOptions) const {
+            auto levelOptions = options;
+            levelOptions.setBinarizer(toZXingBinarizer(level.binarizer));
+            levelOptions.setTryHarder(level.tryHarder);
+            levelOptions.setTryRotate(level.tryRotate);
+            levelOptions.setTryDownscale(level.tryDownscale);
+            // ZXing cannot tell expected from stray codes, so it must not stop on the count
+            levelOptions.setMaxNumberOfSymbols(
+                    decodeOptions.expectedPayloads ? 255
+                                                   : toMaxNumberOfSymbols(decodeOptions.maximumNumberOfCodesToDetect));
+            return levelOptions;
+        }
+
+        [[nodiscard]] size_t levelCount(const DecodeOptions &decodeOptions) const {
+            return std::min(effortLadder.size(), decodeOptions.maximumEffortLevels.value_or(effortLadder.size()));
+        }
+
+        // the binarized image, plus the images downscaled by tryDownscale (1/4 + 1/16 + ...) and their binarizations
+        [[nodiscard]] double bytesPerPixel(const DecodeOptions &decodeOptions) const {
+            const bool downscales =
+                    std::any_of(effortLadder.begin(), effortLadder.begin() + levelCount(decodeOptions),
+                                [](const ZXingEffortLevel &level) { return level.tryDownscale; });
+            return downscales ? 1.0 + 2.0 / 3.0 : 1.0;
+        }
     };
 
     ZXingCodeReader::ZXingCodeReader() : m_impl{std::make_unique<ZXingCodeReaderImpl>()} {
-        m_impl->options.setBinarizer(ZXing::Binarizer::LocalAverage);
-        m_impl->options.setTryHarder(true);
         m_impl->options.setFormats(ZXing::BarcodeFormat::DataMatrix);
     }
 
     ZXingCodeReader::~ZXingCodeReader() = default;
 
-    std::vector<DecodeResult> ZXingCodeReader::decode(const ImageView &image) const {
-        ZXing::ImageView source{image.data, static_cast<int>(image.width), static_cast<int>(image.height),
-                                ZXing::ImageFormat::Lum};
-
-        const auto results = ZXing::ReadBarcodes(source, m_impl->options);
+    std::vector<DecodeResult> ZXingCodeReader::decode(const ImageView &image, const DecodeOptions &options) const {
+        if (options.qualityGate) {
+            return detail::withQualityGate(image, options, [&](const DecodeOptions &gatedOptions) {
+                return decode(image, gatedOptions);
+            });
+        }
+        if (options.memoryLimit) {
+            const auto layout = detail::planScan(image, options, m_impl->bytesPerPixel(options));
+            if (!layout) {
+                return {};
+            }
+            if (!layout->isOriginal(image)) {
+                return detail::decodeInLayout(image, options, *layout,
+                                              [&](const ImageView &strip, const DecodeOptions &stripOptions) {
+                                                  return decode(strip, stripOptions);
+                                              });
+            }
+        }
+        auto results = decodeWithEffortLevels(image, options);
 
         std::vector<DecodeResult> decodeResults;
-        std::ranges::transform(results, std::back_inserter(decodeResults), [&](const auto &result) {
-            const auto zXingPosition = result.position();
-            const auto topLeft = zXingPosition.topLeft();
-            const auto topRight = zXingPosition.topRight();
-            const auto bottomLeft = zXingPosition.bottomLeft();
-            const auto bottomRight = zXingPosition.bottomRight();
-            const CodePosition codePosition{{
-                                                    static_cast<uint32_t>(bottomLeft.x),
-                                                    static_cast<uint32_t>(bottomLeft.y),
-                                            },
-                                            {
-                                                    static_cast<uint32_t>(topLeft.x),
-                                                    static_cast<uint32_t>(topLeft.y),
-                                            },
-                                            {
-                                                    static_cast<uint32_t>(topRight.x),
-                                                    static_cast<uint32_t>(topRight.y),
-                                            },
-                                            {
-                                                    static_cast<uint32_t>(bottomRight.x),
-                                                    static_cast<uint32_t>(bottomRight.y),
-                                            }};
-            return DecodeResult{result.text(), codePosition};
-        });
+        decodeResults.reserve(results.size());
+        std::ranges::transform(results, std::back_inserter(decodeResults),
+                               [](auto &result) { return std::move(result.result); });
+        return decodeResults;
+    }
+    void ZXingCodeReader::decode(const ImageView &image, const DecodeOptions &options,
+                                 DecodeResultBuffer &results) const {
+        if (options.qualityGate) {
+            results.clear();
+            detail::withQualityGate(image, options,
+                                    [&](const DecodeOptions &gatedOptions) { decode(image, gatedOptions, results); });
+            return;
+        }
+        if (options.memoryLimit) {
+            // strips and downscaled copies are merged by decode, the buffer receives a copy of its results
+            results.clear();
+            for (const auto &result: decode(image, options)) {
+                results.push(result.text, result.position);
+            }
+            return;
+        }
+        results.clear();
+        if (m_impl->effortLadder.size() == 1) {
+            if (options.shouldStop() || options.maximumEffortLevels == 0U) {
+                return;
+            }
+            detail::StopCondition stopCondition(options);
+            for (const auto &result: ZXing::ReadBarcodes(toZXingImageView(image),
+                                                         m_impl->optionsFor(m_impl->effortLadder.front(), options))) {
+                const auto position = toCodePosition(result.position());
+                if (stopCondition.isReached()) {
+                    return;
+                }
+                if (detail::matchesHints(position, options.hints)) {
+                    results.push(result.text(), position);
+                    stopCondition.add(result.text());
+                }
+            }
+            return;
+        }
+        for (const auto &result: decodeWithEffortLevels(image, options)) {
+            results.push(result.result.text, result.result.position);
+        }
+    }
+    std::vector<LeveledDecodeResult> ZXingCodeReader::decodeWithEffortLevels(const ImageView &image) const {
+        return decodeWithEffortLevels(image, m_impl->defaultOptions);
+    }
+    std::vector<LeveledDecodeResult> ZXingCodeReader::decodeWithEffortLevels(const ImageView &image,
+                                                                             const DecodeOptions &options) const {
+        const auto zXingImage = toZXingImageView(image);
+
+        detail::StopCondition stopCondition(options);
+        std::vector<LeveledDecodeResult> decodeResults;
+        const auto levelCount = m_impl->levelCount(options);
+        for (size_t level = 0; level < levelCount; ++level) {
+            // ZXing cannot be interrupted, so the deadline and the stop token are only checked before each level
+            if (options.shouldStop()) {
+                break;
+            }
+            const auto results =
+                    ZXing::ReadBarcodes(zXingImage, m_impl->optionsFor(m_impl->effortLadder[level], options));
+            for (const auto &result: results) {
+                const auto position = toCodePosition(result.position());
+                if (!detail::matchesHints(position, options.hints)) {
+                    continue;
+                }
+                // cheaper levels already found this code
+                const bool isDuplicate = std::ranges::any_of(decodeResults, [&](const LeveledDecodeResult &found) {
+                    return detail::diagonallyOppositeMatch(found.result.position, position);
+                });
+                if (!isDuplicate && !stopCondition.isReached()) {
+                    decodeResults.push_back({DecodeResult{result.text(), position}, level});
+                    stopCondition.add(result.text());
+                }
+            }
+            if (stopCondition.isReached()) {
+                break;
+            }
+        }
         return decodeResults;
     }
-    std::vector<DecodeResult> ZXingCodeReader::decode(const ImageView &image,
+    std::vector<DetectionResult> ZXingCodeReader::detect(const ImageView &image, const DecodeOptions &options) const {
+        std::vector<DetectionResult> detections;
+        for (auto &result: decode(image, options)) {
+            detections.push_back({result.position, std::make_shared<ZXingDetectionState>(std::move(result.text))});
+        }
+        return detections;
+    }
+
+    std::optional<DecodeResult> ZXingCodeReader::decode(const ImageView &image, const DetectionResult &detection,
+                                                        const DecodeOptions &options) const {
+        if (const auto *state = dynamic_cast<const ZXingDetectionState *>(detection.state.get())) {
+            return DecodeResult{state->text, detection.position};
+        }
+
+        const auto bounds = detail::bounds(detection.position);
+        const auto searchArea =
+                detail::boundingBox(detection.position, std::max(bounds.width(), bounds.height()) / 2, image);
+        if (searchArea.width() == 0 || searchArea.height() == 0) {
+            return std::nullopt;
+        }
+        // the crop keeps the row stride of the image, the pixels are not copied
+        const auto zXingImage = toZXingImageView(image).cropped(
+                static_cast<int>(searchArea.left), static_cast<int>(searchArea.top),
+                static_cast<int>(searchArea.width()), static_cast<int>(searchArea.height()));
+
+        auto searchOptions = options;
+        searchOptions.maximumNumberOfCodesToDetect = 1;
+        searchOptions.expectedPayloads.reset();
+        const auto levelCount = m_impl->levelCount(options);
+        for (size_t level = 0; level < levelCount && !options.shouldStop(); ++level) {
+            for (const auto &result:
+                 ZXing::ReadBarcodes(zXingImage, m_impl->optionsFor(m_impl->effortLadder[level], searchOptions))) {
+                const auto position = detail::translate(toCodePosition(result.position()), searchArea.left,
+                                                        searchArea.top);
+                if (detail::matchesHints(position, options.hints)) {
+                    return DecodeResult{result.text(), position};
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::vector<DecodeResult> ZXingCodeReader::decode(const ImageView &image, const DecodeOptions &options,
                                                       std::function<void(DecodeResult)> callback) const {
         (void) image;
+        (void) options;
         (void) callback;
         throw std::runtime_error{"Decode with callback is not supported!"};
     }
 
+    MemoryUsage ZXingCodeReader::estimateMemoryUsage(const ImageView &image, const DecodeOptions &options) const {
+        return detail::usageOf(detail::planScan(image, options, m_impl->bytesPerPixel(options)), image,
+                               &MemoryUsage::zxingBuffers);
+    }
+
+    const DecodeOptions &ZXingCodeReader::getDefaultOptions() const { return m_impl->defaultOptions; }
+
     void ZXingCodeReader::setTimeout(uint32_t msec) {
         (void) msec;
         throw std::runtime_error{"setTimeout is not supported!"};
@@ -63,11 +272,31 @@ namespace sfdm {
     bool ZXingCodeReader::isTimeoutSupported() { return false; }
 
     void ZXingCodeReader::setMaximumNumberOfCodesToDetect(size_t count) {
-        if (count > 255) {
-            throw std::runtime_error{"maximum number of codes cannot exceed 255!"};
-        }
-        m_impl->options.setMaxNumberOfSymbols(static_cast<uint8_t>(count));
+        (void) toMaxNumberOfSymbols(count);
+        m_impl->defaultOptions.maximumNumberOfCodesToDetect = count;
+    }
+    size_t ZXingCodeReader::getMaximumNumberOfCodesToDetect() const {
+        return m_impl->defaultOptions.maximumNumberOfCodesToDetect;
     }
-    size_t ZXingCodeReader::getMaximumNumberOfCodesToDetect() const { return m_impl->options.maxNumberOfSymbols(); }
     bool ZXingCodeReader::isDecodeWithCallbackSupported() { return false; }
+
+    void ZXingCodeReader::setEffortLadder(std::vector<ZXingEffortLevel> ladder) {
+        if (ladder.empty()) {
+            throw std::runtime_error{"effort ladder needs at least one level!"};
+        }
+        m_impl->effortLadder = std::move(ladder);
+    }
+    const std::vector<ZXingEffortLevel> &ZXingCodeReader::getEffortLadder() const { return m_impl->effortLadder; }
+
+    void ZXingCodeReader::setHints(const DecodeHints &hints) { m_impl->defaultOptions.hints = hints; }
+    const DecodeHints &ZXingCodeReader::getHints() const { return m_impl->defaultOptions.hints; }
+
+    std::vector<ZXingEffortLevel> ZXingCodeReader::progressiveEffortLadder() {
+        return {
+                {ZXingBinarizer::GlobalHistogram, false, false, false},
+                {ZXingBinarizer::LocalAverage, false, false, false},
+                {ZXingBinarizer::LocalAverage, false, true, true},
+                {ZXingBinarizer::LocalAverage, true, true, true},
+        };
+    }
 } // namespace sfdm
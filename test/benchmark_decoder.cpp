@@ -2,6 +2,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/generators/catch_generators_range.hpp>
+#include <cmath>
+#include <limits>
 #include <set>
 
 #include <sfdm/sfdm.hpp>
@@ -38,6 +40,34 @@ namespace {
         });
         return std::make_pair(images, codeCounts);
     }
+
+    // options are passed per call, the readers are not reconfigured for every image
+    sfdm::DecodeOptions withCodeCount(const sfdm::ICodeReader &reader, size_t codeCount) {
+        auto options = reader.getDefaultOptions();
+        options.maximumNumberOfCodesToDetect = codeCount;
+        return options;
+    }
+
+    double edgeLength(const sfdm::Point &p1, const sfdm::Point &p2) {
+        return std::hypot(static_cast<double>(p1.x) - p2.x, static_cast<double>(p1.y) - p2.y);
+    }
+
+    // tight hints for the dataset: the module size is derived from the smallest code found without hints
+    sfdm::DecodeHints getTightHints(const std::vector<sfdm::ImageView> &images) {
+        sfdm::LibdmtxCodeReader reader;
+        double minEdgeLength = std::numeric_limits<double>::max();
+        for (const auto &image: images) {
+            for (const auto &result: reader.decode(image)) {
+                const auto &position = result.position;
+                minEdgeLength = std::min({minEdgeLength, edgeLength(position.bottomLeft, position.topLeft),
+                                          edgeLength(position.bottomLeft, position.bottomRight)});
+            }
+        }
+        // smallest symbols have 8 modules along their short edge
+        constexpr double smallestModuleCount = 8;
+        const auto minModuleSize = static_cast<uint32_t>(0.8 * minEdgeLength / smallestModuleCount);
+        return {.minModuleSize = std::max(1U, minModuleSize), .edgeThreshold = 20, .squareDeviation = 20, .scanGap = 4};
+    }
 } // namespace
 
 TEST_CASE("Decoder benchmark") {
@@ -48,8 +78,18 @@ TEST_CASE("Decoder benchmark") {
     BENCHMARK_ADVANCED("ZXing")(Catch::Benchmark::Chronometer meter) {
         sfdm::ZXingCodeReader zxingCodeReader;
         meter.measure([&] {
-            zxingCodeReader.setMaximumNumberOfCodesToDetect(codeCounts[counter % codeCounts.size()]);
-            return zxingCodeReader.decode(images[counter++ % images.size()]);
+            const auto index = counter++ % images.size();
+            return zxingCodeReader.decode(images[index], withCodeCount(zxingCodeReader, codeCounts[index]));
+        });
+    };
+
+    counter = 0;
+    BENCHMARK_ADVANCED("ZXing progressive effort ladder")(Catch::Benchmark::Chronometer meter) {
+        sfdm::ZXingCodeReader zxingCodeReader;
+        zxingCodeReader.setEffortLadder(sfdm::ZXingCodeReader::progressiveEffortLadder());
+        meter.measure([&] {
+            const auto index = counter++ % images.size();
+            return zxingCodeReader.decode(images[index], withCodeCount(zxingCodeReader, codeCounts[index]));
         });
     };
 
@@ -58,8 +98,8 @@ TEST_CASE("Decoder benchmark") {
         sfdm::LibdmtxZXingCombinedCodeReader combinedReader;
         combinedReader.setTimeout(0);
         meter.measure([&] {
-            combinedReader.setMaximumNumberOfCodesToDetect(codeCounts[counter % codeCounts.size()]);
-            return combinedReader.decode(images[counter++ % images.size()]);
+            const auto index = counter++ % images.size();
+            return combinedReader.decode(images[index], withCodeCount(combinedReader, codeCounts[index]));
         });
     };
 
@@ -68,8 +108,20 @@ TEST_CASE("Decoder benchmark") {
         sfdm::LibdmtxZXingCombinedCodeReader combinedReader;
         combinedReader.setTimeout(100);
         meter.measure([&] {
-            combinedReader.setMaximumNumberOfCodesToDetect(codeCounts[counter % codeCounts.size()]);
-            return combinedReader.decode(images[counter++ % images.size()]);
+            const auto index = counter++ % images.size();
+            return combinedReader.decode(images[index], withCodeCount(combinedReader, codeCounts[index]));
+        });
+    };
+
+    // ZXing stops the libdmtx search, once it found all codes
+    counter = 0;
+    BENCHMARK_ADVANCED("Combined 100ms without double check")(Catch::Benchmark::Chronometer meter) {
+        sfdm::LibdmtxZXingCombinedCodeReader combinedReader;
+        combinedReader.setTimeout(100);
+        combinedReader.setDoubleCheckZXing(false);
+        meter.measure([&] {
+            const auto index = counter++ % images.size();
+            return combinedReader.decode(images[index], withCodeCount(combinedReader, codeCounts[index]));
         });
     };
 
@@ -78,8 +130,8 @@ TEST_CASE("Decoder benchmark") {
         sfdm::LibdmtxZXingCombinedCodeReader combinedReader;
         combinedReader.setTimeout(200);
         meter.measure([&] {
-            combinedReader.setMaximumNumberOfCodesToDetect(codeCounts[counter % codeCounts.size()]);
-            return combinedReader.decode(images[counter++ % images.size()]);
+            const auto index = counter++ % images.size();
+            return combinedReader.decode(images[index], withCodeCount(combinedReader, codeCounts[index]));
         });
     };
 
@@ -88,8 +140,8 @@ TEST_CASE("Decoder benchmark") {
         sfdm::LibdmtxCodeReader dmtxCodeReader;
         dmtxCodeReader.setTimeout(0);
         meter.measure([&] {
-            dmtxCodeReader.setMaximumNumberOfCodesToDetect(codeCounts[counter % codeCounts.size()]);
-            return dmtxCodeReader.decode(images[counter++ % images.size()]);
+            const auto index = counter++ % images.size();
+            return dmtxCodeReader.decode(images[index], withCodeCount(dmtxCodeReader, codeCounts[index]));
         });
     };
 
@@ -98,8 +150,8 @@ TEST_CASE("Decoder benchmark") {
         sfdm::LibdmtxCodeReader dmtxCodeReader100ms;
         dmtxCodeReader100ms.setTimeout(100);
         meter.measure([&] {
-            dmtxCodeReader100ms.setMaximumNumberOfCodesToDetect(codeCounts[counter % codeCounts.size()]);
-            return dmtxCodeReader100ms.decode(images[counter++ % images.size()]);
+            const auto index = counter++ % images.size();
+            return dmtxCodeReader100ms.decode(images[index], withCodeCount(dmtxCodeReader100ms, codeCounts[index]));
         });
     };
 
@@ -108,8 +160,143 @@ TEST_CASE("Decoder benchmark") {
         sfdm::LibdmtxCodeReader dmtxCodeReader200ms;
         dmtxCodeReader200ms.setTimeout(200);
         meter.measure([&] {
-            dmtxCodeReader200ms.setMaximumNumberOfCodesToDetect(codeCounts[counter % codeCounts.size()]);
-            return dmtxCodeReader200ms.decode(images[counter++ % images.size()]);
+            const auto index = counter++ % images.size();
+            return dmtxCodeReader200ms.decode(images[index], withCodeCount(dmtxCodeReader200ms, codeCounts[index]));
         });
     };
 }
+
+TEST_CASE("Decode hints benchmark") {
+    auto imagesAndFileNames = getImagesFromFiles();
+    auto [images, codeCounts] = getImagesAndCodeCounts(imagesAndFileNames);
+    const auto hints = getTightHints(images);
+
+    int counter = 0;
+    BENCHMARK_ADVANCED("Libdmtx 100ms without hints")(Catch::Benchmark::Chronometer meter) {
+        sfdm::LibdmtxCodeReader dmtxCodeReader;
+        dmtxCodeReader.setTimeout(100);
+        meter.measure([&] {
+            const auto index = counter++ % images.size();
+            return dmtxCodeReader.decode(images[index], withCodeCount(dmtxCodeReader, codeCounts[index]));
+        });
+    };
+
+    counter = 0;
+    BENCHMARK_ADVANCED("Libdmtx 100ms tight hints")(Catch::Benchmark::Chronometer meter) {
+        sfdm::LibdmtxCodeReader dmtxCodeReader;
+        dmtxCodeReader.setTimeout(100);
+        dmtxCodeReader.setHints(hints);
+        meter.measure([&] {
+            const auto index = counter++ % images.size();
+            return dmtxCodeReader.decode(images[index], withCodeCount(dmtxCodeReader, codeCounts[index]));
+        });
+    };
+
+    counter = 0;
+    BENCHMARK_ADVANCED("Combined 100ms tight hints")(Catch::Benchmark::Chronometer meter) {
+        sfdm::LibdmtxZXingCombinedCodeReader combinedReader;
+        combinedReader.setTimeout(100);
+        combinedReader.setHints(hints);
+        meter.measure([&] {
+            const auto index = counter++ % images.size();
+            return combinedReader.decode(images[index], withCodeCount(combinedReader, codeCounts[index]));
+        });
+    };
+}
+
+TEST_CASE("Detection benchmark") {
+    auto imagesAndFileNames = getImagesFromFiles();
+    auto [images, codeCounts] = getImagesAndCodeCounts(imagesAndFileNames);
+
+    int counter = 0;
+    BENCHMARK_ADVANCED("Libdmtx 100ms decode")(Catch::Benchmark::Chronometer meter) {
+        sfdm::LibdmtxCodeReader dmtxCodeReader;
+        dmtxCodeReader.setTimeout(100);
+        meter.measure([&] {
+            const auto index = counter++ % images.size();
+            return dmtxCodeReader.decode(images[index], withCodeCount(dmtxCodeReader, codeCounts[index]));
+        });
+    };
+
+    counter = 0;
+    BENCHMARK_ADVANCED("Libdmtx 100ms detect")(Catch::Benchmark::Chronometer meter) {
+        sfdm::LibdmtxCodeReader dmtxCodeReader;
+        dmtxCodeReader.setTimeout(100);
+        meter.measure([&] {
+            const auto index = counter++ % images.size();
+            return dmtxCodeReader.detect(images[index], withCodeCount(dmtxCodeReader, codeCounts[index]));
+        });
+    };
+}
+
+TEST_CASE("Static dispatch benchmark") {
+    auto imagesAndFileNames = getImagesFromFiles();
+    auto [images, codeCounts] = getImagesAndCodeCounts(imagesAndFileNames);
+
+    int counter = 0;
+    BENCHMARK_ADVANCED("ZXing virtual")(Catch::Benchmark::Chronometer meter) {
+        const std::unique_ptr<sfdm::ICodeReader> reader = std::make_unique<sfdm::ZXingCodeReader>();
+        meter.measure([&] {
+            const auto index = counter++ % images.size();
+            return reader->decode(images[index], withCodeCount(*reader, codeCounts[index]));
+        });
+    };
+
+    counter = 0;
+    BENCHMARK_ADVANCED("ZXing composite")(Catch::Benchmark::Chronometer meter) {
+        const sfdm::CompositeReader<sfdm::SequentialStrategy, sfdm::ZXingCodeReader> reader;
+        const auto &defaultOptions = reader.getBackend<0>().getDefaultOptions();
+        meter.measure([&] {
+            const auto index = counter++ % images.size();
+            auto options = defaultOptions;
+            options.maximumNumberOfCodesToDetect = codeCounts[index];
+            size_t count = 0;
+            return reader.decode(images[index], options, [&count](sfdm::DecodeResult &&) { ++count; });
+        });
+    };
+
+    counter = 0;
+    BENCHMARK_ADVANCED("Combined 100ms virtual")(Catch::Benchmark::Chronometer meter) {
+        std::unique_ptr<sfdm::ICodeReader> reader = std::make_unique<sfdm::LibdmtxZXingCombinedCodeReader>();
+        reader->setTimeout(100);
+        meter.measure([&] {
+            const auto index = counter++ % images.size();
+            return reader->decode(images[index], withCodeCount(*reader, codeCounts[index]));
+        });
+    };
+
+    counter = 0;
+    BENCHMARK_ADVANCED("Merged 100ms composite")(Catch::Benchmark::Chronometer meter) {
+        const sfdm::MergedLibdmtxZXingReader reader;
+        meter.measure([&] {
+            const auto index = counter++ % images.size();
+            const sfdm::DecodeOptions options{.timeoutMSec = 100, .maximumNumberOfCodesToDetect = codeCounts[index]};
+            return reader.decode(images[index], options);
+        });
+    };
+}
+
+TEST_CASE("Image quality benchmark") {
+    auto imagesAndFileNames = getImagesFromFiles();
+    auto [images, codeCounts] = getImagesAndCodeCounts(imagesAndFileNames);
+
+    // the gate only pays off if the measurement is cheap next to the decode it guards
+    int counter = 0;
+    BENCHMARK_ADVANCED("Image quality")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] { return sfdm::measureImageQuality(images[counter++ % images.size()]); });
+    };
+
+    counter = 0;
+    BENCHMARK_ADVANCED("Image quality every pixel")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] { return sfdm::measureImageQuality(images[counter++ % images.size()], 1); });
+    };
+
+    counter = 0;
+    BENCHMARK_ADVANCED("Libdmtx 100ms rejected by the quality gate")(Catch::Benchmark::Chronometer meter) {
+        const sfdm::LibdmtxCodeReader reader;
+        // thresholds no frame meets, so only the measurement is timed
+        const sfdm::DecodeOptions options{.timeoutMSec = 100,
+                                          .qualityGate = sfdm::QualityGate{.minSharpness = 1e9}};
+        meter.measure([&] { return reader.decode(images[counter++ % images.size()], options); });
+    };
+}
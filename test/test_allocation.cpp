@@ -0,0 +1,69 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdlib>
+#include <new>
+
+#include <sfdm/sfdm.hpp>
+
+#include "test_utils.hpp"
+
+// Counts the C++ heap allocations of the current thread. Allocations libdmtx does with malloc are not counted.
+namespace {
+    thread_local bool countAllocations = false;
+    thread_local size_t allocationCount = 0;
+
+    class AllocationCounter {
+    public:
+        AllocationCounter() {
+            allocationCount = 0;
+            countAllocations = true;
+        }
+        ~AllocationCounter() { countAllocations = false; }
+        AllocationCounter(const AllocationCounter &) = delete;
+        AllocationCounter &operator=(const AllocationCounter &) = delete;
+
+        [[nodiscard]] size_t count() const { return allocationCount; }
+    };
+} // namespace
+
+void *operator new(size_t size) {
+    if (countAllocations) {
+        ++allocationCount;
+    }
+    if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+
+TEST_CASE("Zero allocation decoding") {
+    const auto annotated = getAnnotatedImage();
+    const auto view = toView(annotated.image);
+
+    sfdm::LibdmtxCodeReader reader;
+    reader.setTimeout(100);
+    reader.setMaximumNumberOfCodesToDetect(annotated.texts.size());
+
+    SECTION("Decode into buffer") {
+        sfdm::DecodeResultBuffer buffer;
+        reader.decode(view, buffer);
+        const auto expected = buffer.toDecodeResults();
+        REQUIRE(expected == reader.decode(view));
+
+        {
+            AllocationCounter counter;
+            reader.decode(view, buffer);
+            REQUIRE(counter.count() == 0);
+        }
+        REQUIRE(buffer.toDecodeResults() == expected);
+    }
+
+    SECTION("Result stream frames are reused") {
+        { auto stream = reader.decodeStream(view); }
+
+        AllocationCounter counter;
+        { auto stream = reader.decodeStream(view); }
+        REQUIRE(counter.count() == 0);
+    }
+}
@@ -0,0 +1,134 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sfdm/sfdm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+#include "test_utils.hpp"
+
+namespace {
+    std::vector<std::string> sortedTexts(const std::vector<sfdm::DecodeResult> &results) {
+        std::vector<std::string> texts;
+        std::ranges::transform(results, std::back_inserter(texts), &sfdm::DecodeResult::text);
+        std::ranges::sort(texts);
+        return texts;
+    }
+
+    // best of three, so a preempted run does not count
+    std::chrono::steady_clock::duration fastestDecode(const sfdm::ICodeReader &reader, const sfdm::ImageView &image,
+                                                      const std::function<sfdm::DecodeOptions()> &makeOptions) {
+        auto fastest = std::chrono::steady_clock::duration::max();
+        for (int run = 0; run < 3; ++run) {
+            const auto options = makeOptions();
+            const auto start = std::chrono::steady_clock::now();
+            (void) reader.decode(image, options);
+            fastest = std::min(fastest, std::chrono::steady_clock::now() - start);
+        }
+        return fastest;
+    }
+
+    std::vector<sfdm::CodePosition> positionsOf(const std::vector<sfdm::DecodeResult> &results) {
+        std::vector<sfdm::CodePosition> positions;
+        std::ranges::transform(results, std::back_inserter(positions), &sfdm::DecodeResult::position);
+        return positions;
+    }
+} // namespace
+
+TEST_CASE("Code location prior") {
+    const sfdm::ImageView image{100, 100, nullptr};
+    // a code around (75, 25), in the top right cell of a 2x2 heatmap. Halving keeps the heat exact.
+    const std::vector<sfdm::CodePosition> positions{{{70, 30}, {70, 20}, {80, 20}, {80, 30}}};
+    sfdm::CodeLocationPrior prior(2, 2, 0.5);
+
+    prior.observe(image, positions);
+    CHECK(prior.getHeat(1, 0) == 1.0);
+    CHECK(prior.getHeat(0, 1) == 0.0);
+
+    SECTION("Heat decays with every frame") {
+        prior.observe(image, {});
+        CHECK(prior.getHeat(1, 0) == 0.5);
+        prior.observe(image, {});
+        CHECK(prior.getHotCells(0.3).empty());
+    }
+    SECTION("Hottest cells first") {
+        const std::vector<sfdm::CodePosition> lowerLeft{{{10, 90}, {10, 80}, {20, 80}, {20, 90}}};
+        prior.observe(image, lowerLeft);
+        prior.observe(image, lowerLeft);
+        const auto cells = prior.getHotCells();
+        REQUIRE(cells.size() == 2);
+        CHECK((cells[0].column == 0 && cells[0].row == 1));
+        CHECK((cells[1].column == 1 && cells[1].row == 0));
+    }
+    SECTION("Reset") {
+        prior.reset();
+        CHECK(prior.getHotCells().empty());
+    }
+    SECTION("Invalid parameters") {
+        CHECK_THROWS(sfdm::CodeLocationPrior(0, 2));
+        CHECK_THROWS(sfdm::CodeLocationPrior(2, 2, 0.0));
+        CHECK_THROWS(prior.getHeat(2, 0));
+    }
+}
+
+TEST_CASE("Code location prior orders the libdmtx scan") {
+    const auto annotated = getAnnotatedImage();
+    const auto view = toView(annotated.image);
+
+    const sfdm::LibdmtxCodeReader reader;
+    sfdm::DecodeOptions options{.timeoutMSec = 0};
+    const auto expected = reader.decode(view, options);
+    REQUIRE_FALSE(expected.empty());
+
+    options.locationPrior = std::make_shared<sfdm::CodeLocationPrior>();
+
+    SECTION("Codes in their usual places") {
+        options.locationPrior->observe(view, positionsOf(expected));
+        const auto results = reader.decode(view, options);
+        CHECK(sortedTexts(results) == sortedTexts(expected));
+    }
+    SECTION("The whole image is searched after the hot areas") {
+        // codes seen in the top left corner only
+        const std::vector<sfdm::CodePosition> corner{{{0, 10}, {0, 0}, {10, 0}, {10, 10}}};
+        options.locationPrior->observe(view, corner);
+        const auto results = reader.decode(view, options);
+        CHECK(sortedTexts(results) == sortedTexts(expected));
+    }
+    SECTION("Hot areas without codes cost little") {
+        // codes seen along the whole top edge, more hot cells than are searched first
+        const auto topEdgePrior = [&] {
+            auto prior = std::make_shared<sfdm::CodeLocationPrior>();
+            std::vector<sfdm::CodePosition> topEdge;
+            for (uint32_t x = 0; x + 10 < view.width; x += static_cast<uint32_t>(view.width / 8)) {
+                topEdge.push_back({{x, 10}, {x, 0}, {x + 10, 0}, {x + 10, 10}});
+            }
+            prior->observe(view, topEdge);
+            return prior;
+        };
+        auto timedOptions = options;
+        timedOptions.timeoutMSec = 100;
+        timedOptions.locationPrior.reset();
+        const auto withoutPrior = fastestDecode(reader, view, [&] { return timedOptions; });
+        const auto withPrior = fastestDecode(reader, view, [&] {
+            auto priorOptions = timedOptions;
+            // a fresh prior for every run, decode feeds the found codes into it
+            priorOptions.locationPrior = topEdgePrior();
+            return priorOptions;
+        });
+        // the hot areas share one timeout, the exact cost belongs into a benchmark. The bound only catches a prior,
+        // that makes the decode hang, without failing on loaded machines.
+        CHECK(withPrior <= withoutPrior * 2 + std::chrono::seconds{1});
+
+        options.locationPrior = topEdgePrior();
+        CHECK(sortedTexts(reader.decode(view, options)) == sortedTexts(expected));
+    }
+    SECTION("Decoded codes are fed into the prior") {
+        (void) reader.decode(view, options);
+        CHECK(options.locationPrior->getHotCells().size() >= 1);
+        // the buffer is filled from the same scan
+        sfdm::DecodeResultBuffer buffer;
+        reader.decode(view, options, buffer);
+        CHECK(buffer.size() == expected.size());
+    }
+}
@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sfdm/composite_reader.hpp>
+#include <sfdm/sfdm.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "test_utils.hpp"
+
+namespace {
+    sfdm::DecodeResult resultAt(std::string text, uint32_t x) {
+        return {std::move(text), {{x, 10}, {x, 0}, {x + 10, 0}, {x + 10, 10}}};
+    }
+
+    // returns fixed results after a delay, or as soon as it is stopped, and counts its calls
+    struct FixedBackend {
+        std::vector<sfdm::DecodeResult> results;
+        std::chrono::milliseconds delay{0};
+        std::shared_ptr<std::atomic<int>> calls{std::make_shared<std::atomic<int>>(0)};
+
+        [[nodiscard]] std::vector<sfdm::DecodeResult> decode(const sfdm::ImageView &,
+                                                             const sfdm::DecodeOptions &options) const {
+            ++*calls;
+            const auto end = std::chrono::steady_clock::now() + delay;
+            while (std::chrono::steady_clock::now() < end) {
+                if (options.shouldStop()) {
+                    return {};
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+            return results;
+        }
+    };
+
+    struct ThrowingBackend {
+        [[nodiscard]] std::vector<sfdm::DecodeResult> decode(const sfdm::ImageView &,
+                                                             const sfdm::DecodeOptions &) const {
+            throw std::runtime_error{"backend failed"};
+        }
+    };
+
+    const sfdm::ImageView emptyView{0, 0, nullptr};
+} // namespace
+
+TEST_CASE("Composite reader strategies") {
+    FixedBackend first{{resultAt("a", 0), resultAt("b", 100)}};
+    FixedBackend second{{resultAt("b", 101), resultAt("c", 200)}};
+
+    SECTION("Sequential") {
+        const sfdm::CompositeReader<sfdm::SequentialStrategy, FixedBackend, FixedBackend> reader{FixedBackend{first},
+                                                                                                 FixedBackend{second}};
+        CHECK(reader.decode(emptyView, {.maximumNumberOfCodesToDetect = 3}) ==
+              std::vector{resultAt("a", 0), resultAt("b", 100), resultAt("c", 200)});
+
+        // the first backend found enough codes, the second is not asked
+        CHECK(reader.decode(emptyView, {.maximumNumberOfCodesToDetect = 2}).size() == 2);
+        CHECK(*first.calls == 2);
+        CHECK(*second.calls == 1);
+    }
+    SECTION("Racing") {
+        second.delay = std::chrono::seconds{10};
+        const sfdm::CompositeReader<sfdm::RacingStrategy, FixedBackend, FixedBackend> reader{FixedBackend{second},
+                                                                                             FixedBackend{first}};
+        const auto start = std::chrono::steady_clock::now();
+        CHECK(reader.decode(emptyView, {}) == first.results);
+        // the slow backend is stopped, once the fast one won
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds{1});
+        CHECK(*second.calls == 1);
+    }
+    SECTION("Merging stops at the maximum number of codes") {
+        second.delay = std::chrono::seconds{10};
+        const sfdm::CompositeReader<sfdm::MergingStrategy, FixedBackend, FixedBackend> reader{FixedBackend{second},
+                                                                                              FixedBackend{first}};
+        const auto start = std::chrono::steady_clock::now();
+        CHECK(reader.decode(emptyView, {.maximumNumberOfCodesToDetect = 2}) == first.results);
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds{1});
+    }
+    SECTION("Errors of a backend are rethrown") {
+        second.delay = std::chrono::seconds{10};
+        const sfdm::CompositeReader<sfdm::RacingStrategy, FixedBackend, ThrowingBackend> reader{FixedBackend{second},
+                                                                                                ThrowingBackend{}};
+        const auto start = std::chrono::steady_clock::now();
+        CHECK_THROWS_AS(reader.decode(emptyView, {}), std::runtime_error);
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds{1});
+    }
+    SECTION("Merging") {
+        const sfdm::CompositeReader<sfdm::MergingStrategy, FixedBackend, FixedBackend> reader{FixedBackend{first},
+                                                                                              FixedBackend{second}};
+        const auto results = reader.decode(emptyView, {});
+        CHECK(results.size() == 3);
+    }
+    SECTION("Sink") {
+        const sfdm::CompositeReader<sfdm::MergingStrategy, FixedBackend> reader{FixedBackend{first}};
+        std::vector<std::string> texts;
+        const auto count = reader.decode(emptyView, {}, [&](sfdm::DecodeResult &&result) {
+            texts.emplace_back(std::move(result.text));
+        });
+        CHECK(count == 2);
+        CHECK(texts == std::vector<std::string>{"a", "b"});
+    }
+}
+
+TEST_CASE("Composite reader with library backends") {
+    const auto annotated = getAnnotatedImage();
+    const auto view = toView(annotated.image);
+
+    const sfdm::ZXingCodeReader zxingReader;
+    const sfdm::CompositeReader<sfdm::SequentialStrategy, sfdm::ZXingCodeReader> single;
+    CHECK(single.decode(view, zxingReader.getDefaultOptions()) == zxingReader.decode(view));
+
+    const sfdm::MergedLibdmtxZXingReader merged;
+    const auto results = merged.decode(view, {.timeoutMSec = 0});
+    CHECK(results.size() >= annotated.texts.size());
+}
@@ -0,0 +1,111 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sfdm/sfdm.hpp>
+
+#include <thread>
+
+#include "test_utils.hpp"
+
+namespace {
+    struct LabeledView {
+        sfdm::ImageView view;
+        size_t codeCount;
+    };
+
+    std::vector<LabeledView> getLabeledViews(const std::vector<std::pair<cv::Mat, std::string>> &images) {
+        const auto data = readDataMatrixFile("../_deps/images-src/annotations.txt");
+        std::vector<LabeledView> views;
+        for (const auto &[image, fileName]: images) {
+            const auto it = data.find(fileName);
+            if (it != data.end()) {
+                views.push_back({{static_cast<size_t>(image.cols), static_cast<size_t>(image.rows), image.data},
+                                 it->second.size()});
+            }
+        }
+        return views;
+    }
+
+    // every thread decodes all images with its own code counts, the results have to match sequential decoding
+    void checkSharedReader(const sfdm::ICodeReader &reader, const sfdm::DecodeOptions &baseOptions) {
+        const auto images = getImagesFromFiles();
+        const auto views = getLabeledViews(images);
+        REQUIRE_FALSE(views.empty());
+
+        const auto optionsFor = [&](const LabeledView &view, size_t threadIndex) {
+            auto options = baseOptions;
+            options.maximumNumberOfCodesToDetect = threadIndex % 2 ? view.codeCount : 1;
+            return options;
+        };
+
+        constexpr size_t threadCount = 4;
+        std::vector<std::vector<std::vector<sfdm::DecodeResult>>> expected(threadCount);
+        for (size_t t = 0; t < threadCount; ++t) {
+            for (const auto &view: views) {
+                expected[t].emplace_back(reader.decode(view.view, optionsFor(view, t)));
+            }
+        }
+
+        std::vector<std::vector<std::vector<sfdm::DecodeResult>>> actual(threadCount);
+        {
+            std::vector<std::jthread> threads;
+            for (size_t t = 0; t < threadCount; ++t) {
+                threads.emplace_back([&, t] {
+                    for (const auto &view: views) {
+                        actual[t].emplace_back(reader.decode(view.view, optionsFor(view, t)));
+                    }
+                });
+            }
+        }
+        for (size_t t = 0; t < threadCount; ++t) {
+            CHECK(actual[t] == expected[t]);
+        }
+    }
+} // namespace
+
+TEST_CASE("Shared reader with per call options") {
+    SECTION("ZXing") {
+        const sfdm::ZXingCodeReader reader;
+        checkSharedReader(reader, reader.getDefaultOptions());
+    }
+    SECTION("libdmtx") {
+        // without timeout, so the results do not depend on the load of the machine
+        const sfdm::LibdmtxCodeReader reader;
+        checkSharedReader(reader, {.timeoutMSec = 0});
+    }
+}
+
+TEST_CASE("Default options follow the setters") {
+    sfdm::LibdmtxZXingCombinedCodeReader reader;
+    reader.setTimeout(50);
+    reader.setMaximumNumberOfCodesToDetect(3);
+    reader.setHints({.minModuleSize = 2});
+    const auto &options = reader.getDefaultOptions();
+    CHECK(options.timeoutMSec == 50);
+    CHECK(options.maximumNumberOfCodesToDetect == 3);
+    CHECK(options.hints == sfdm::DecodeHints{.minModuleSize = 2});
+}
+
+TEST_CASE("Expired deadline") {
+    const auto annotated = getAnnotatedImage();
+    const auto view = toView(annotated.image);
+    const sfdm::DecodeOptions options{.deadline = std::chrono::steady_clock::now()};
+
+    CHECK(sfdm::LibdmtxCodeReader{}.decode(view, options).empty());
+    CHECK(sfdm::ZXingCodeReader{}.decode(view, options).empty());
+    CHECK(sfdm::LibdmtxZXingCombinedCodeReader{}.decode(view, options).empty());
+}
+
+TEST_CASE("Stop requested") {
+    const auto annotated = getAnnotatedImage();
+    const auto view = toView(annotated.image);
+    std::stop_source stopSource;
+    stopSource.request_stop();
+    sfdm::DecodeOptions options;
+    options.stopToken = stopSource.get_token();
+
+    CHECK(sfdm::LibdmtxCodeReader{}.decode(view, options).empty());
+    CHECK(sfdm::ZXingCodeReader{}.decode(view, options).empty());
+    CHECK(sfdm::LibdmtxZXingCombinedCodeReader{}.decode(view, options).empty());
+    CHECK(sfdm::LibdmtxCodeReader{}.detect(view, options).empty());
+}
+
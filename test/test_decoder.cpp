@@ -15,6 +15,20 @@
 // #define PAINT_FOUND_CODES
 
 namespace {
+    // the image thresholded to black and white, and beside it the image without black pixels
+    cv::Mat blackAndWhiteBesideGray(const cv::Mat &image) {
+        cv::Mat result(image.rows, 2 * image.cols, CV_8UC1);
+        for (int y = 0; y < image.rows; ++y) {
+            const auto *source = image.ptr(y);
+            auto *target = result.ptr(y);
+            for (int x = 0; x < image.cols; ++x) {
+                target[x] = source[x] < 128 ? 0 : 255;
+                target[image.cols + x] = static_cast<uint8_t>(1 + source[x] * 254 / 255);
+            }
+        }
+        return result;
+    }
+
     auto getTexts(const auto &foundData) {
         std::vector<std::string> foundTexts;
         foundTexts.reserve(foundData.size());
@@ -173,6 +187,89 @@ TEST_CASE("ZXing Decoding") {
     });
 }
 
+TEST_CASE("ZXing Decoding with the progressive effort ladder") {
+    testDecoding([](const cv::Mat &image, const std::string &codeName, size_t expectedNumberOfCodes) {
+        sfdm::ZXingCodeReader reader;
+        reader.setEffortLadder(sfdm::ZXingCodeReader::progressiveEffortLadder());
+        reader.setMaximumNumberOfCodesToDetect(expectedNumberOfCodes);
+        return testReader(reader, image, "zxing", codeName);
+    });
+}
+
+TEST_CASE("ZXing effort ladder") {
+    sfdm::ZXingCodeReader reader;
+    REQUIRE(reader.getEffortLadder() == std::vector{sfdm::ZXingEffortLevel{}});
+    REQUIRE_THROWS(reader.setEffortLadder({}));
+
+    // BoolCast only reads black pixels as black, so the first level finds the codes of the left half only
+    reader.setEffortLadder({{sfdm::ZXingBinarizer::BoolCast, false, false, false}, sfdm::ZXingEffortLevel{}});
+    const auto image = blackAndWhiteBesideGray(getAnnotatedImage().image);
+    const sfdm::ImageView view{static_cast<size_t>(image.cols), static_cast<size_t>(image.rows), image.data};
+    const auto isInRightHalf = [&](const sfdm::LeveledDecodeResult &result) {
+        return result.result.position.topLeft.x >= static_cast<uint32_t>(image.cols / 2);
+    };
+
+    sfdm::DecodeOptions options;
+    options.maximumEffortLevels = 1;
+    const auto firstLevel = reader.decodeWithEffortLevels(view, options);
+    REQUIRE_FALSE(firstLevel.empty());
+    CHECK(std::ranges::none_of(firstLevel, isInRightHalf));
+    options.maximumEffortLevels.reset();
+
+    SECTION("Escalation stops once the maximum number of codes was found") {
+        options.maximumNumberOfCodesToDetect = firstLevel.size();
+        CHECK(reader.decodeWithEffortLevels(view, options) == firstLevel);
+
+        options.maximumNumberOfCodesToDetect = firstLevel.size() + 1;
+        const auto results = reader.decodeWithEffortLevels(view, options);
+        REQUIRE(results.size() == firstLevel.size() + 1);
+        CHECK(results.back().effortLevel == 1);
+    }
+    SECTION("Later levels add the codes the earlier levels missed") {
+        const auto results = reader.decodeWithEffortLevels(view, options);
+        REQUIRE(results.size() > firstLevel.size());
+        CHECK(std::equal(firstLevel.begin(), firstLevel.end(), results.begin()));
+        const auto laterLevels = results | std::views::drop(firstLevel.size());
+        CHECK(std::ranges::all_of(laterLevels, [](const auto &result) { return result.effortLevel == 1; }));
+        CHECK(std::ranges::any_of(laterLevels, isInRightHalf));
+    }
+}
+
+TEST_CASE("Decode hints") {
+    SECTION("Unsupported symbol sizes are rejected") {
+        sfdm::LibdmtxCodeReader reader;
+        REQUIRE_THROWS(reader.setHints({.symbolSizes = {{11, 11}}}));
+        REQUIRE(reader.getHints() == sfdm::DecodeHints{});
+    }
+    SECTION("Combined reader passes hints on") {
+        const sfdm::DecodeHints hints{.symbolSizes = {{16, 16}, {12, 36}}, .minModuleSize = 3, .scanGap = 4};
+        sfdm::LibdmtxZXingCombinedCodeReader reader;
+        reader.setHints(hints);
+        REQUIRE(reader.getHints() == hints);
+    }
+    SECTION("Hints that match no code") {
+        const sfdm::DecodeHints hints{.shape = sfdm::SymbolShape::Rectangle, .minModuleSize = 200};
+        const auto &[image, fileName] = getImagesFromFiles().front();
+        const sfdm::ImageView view{static_cast<size_t>(image.cols), static_cast<size_t>(image.rows), image.data};
+
+        sfdm::LibdmtxCodeReader libdmtxReader;
+        libdmtxReader.setHints(hints);
+        CHECK(libdmtxReader.decode(view).empty());
+
+        sfdm::ZXingCodeReader zxingReader;
+        zxingReader.setHints(hints);
+        CHECK(zxingReader.decode(view).empty());
+    }
+    SECTION("Loose hints") {
+        testDecoding([](const cv::Mat &image, const std::string &codeName, size_t expectedNumberOfCodes) {
+            sfdm::LibdmtxCodeReader reader;
+            reader.setHints({.minModuleSize = 1});
+            reader.setMaximumNumberOfCodesToDetect(expectedNumberOfCodes);
+            return testReader(reader, image, "libdmtx", codeName);
+        });
+    }
+}
+
 TEST_CASE("Combined Decoding") {
     const auto timeout = GENERATE_REF(from_range(std::vector{100, 200, 0}));
     SECTION(std::to_string(timeout) + "ms timeout") {
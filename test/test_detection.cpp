@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sfdm/sfdm.hpp>
+
+#include <algorithm>
+
+#include "test_utils.hpp"
+
+namespace {
+    // every decoded code has to be detected, and decoding the detection has to give the same text
+    void checkLazyDecode(const sfdm::ICodeReader &reader, const sfdm::DecodeOptions &options) {
+        const auto annotated = getAnnotatedImage();
+        const auto view = toView(annotated.image);
+        const auto expected = reader.decode(view, options);
+        REQUIRE_FALSE(expected.empty());
+
+        const auto detections = reader.detect(view, options);
+        CHECK(detections.size() >= expected.size());
+        for (const auto &result: expected) {
+            const auto detection = std::ranges::find_if(detections, [&](const sfdm::DetectionResult &detection) {
+                return isNear(detection.position.bottomLeft, result.position.bottomLeft) &&
+                       isNear(detection.position.topRight, result.position.topRight);
+            });
+            REQUIRE(detection != detections.end());
+            const auto decoded = reader.decode(view, *detection, options);
+            REQUIRE(decoded);
+            CHECK(decoded->text == result.text);
+        }
+    }
+} // namespace
+
+TEST_CASE("Detect and decode lazily") {
+    SECTION("libdmtx") {
+        // without timeout, so the results do not depend on the load of the machine
+        checkLazyDecode(sfdm::LibdmtxCodeReader{}, {.timeoutMSec = 0});
+    }
+    SECTION("ZXing") {
+        const sfdm::ZXingCodeReader reader;
+        checkLazyDecode(reader, reader.getDefaultOptions());
+    }
+    SECTION("Combined") {
+        checkLazyDecode(sfdm::LibdmtxZXingCombinedCodeReader{}, {.timeoutMSec = 0});
+    }
+}
+
+TEST_CASE("Detection limits") {
+    const auto annotated = getAnnotatedImage();
+    const auto view = toView(annotated.image);
+    const sfdm::LibdmtxCodeReader reader;
+
+    CHECK(reader.detect(view, {.timeoutMSec = 0, .maximumNumberOfCodesToDetect = 1}).size() == 1);
+    CHECK(reader.detect(view, {.deadline = std::chrono::steady_clock::now()}).empty());
+}
+
+TEST_CASE("Decode a position without detection state") {
+    const auto annotated = getAnnotatedImage();
+    const auto view = toView(annotated.image);
+    const sfdm::LibdmtxCodeReader libdmtxReader;
+    const sfdm::ZXingCodeReader zxingReader;
+    const sfdm::DecodeOptions options{.timeoutMSec = 0};
+
+    const auto expected = libdmtxReader.decode(view, options);
+    REQUIRE_FALSE(expected.empty());
+    // e.g. a position from an earlier frame
+    const sfdm::DetectionResult detection{expected.front().position, nullptr};
+
+    const auto libdmtxResult = libdmtxReader.decode(view, detection, options);
+    REQUIRE(libdmtxResult);
+    CHECK(libdmtxResult->text == expected.front().text);
+
+    const auto zxingExpected = zxingReader.decode(view);
+    REQUIRE_FALSE(zxingExpected.empty());
+    const auto zxingResult = zxingReader.decode(view, sfdm::DetectionResult{zxingExpected.front().position, nullptr});
+    REQUIRE(zxingResult);
+    CHECK(zxingResult->text == zxingExpected.front().text);
+}
@@ -0,0 +1,88 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sfdm/sfdm.hpp>
+
+#include "stop_condition.hpp"
+#include "test_utils.hpp"
+
+namespace {
+    // the codes found before the last code are stray codes then and must not count towards the maximum of 1
+    void checkStopsAtExpectedPayload(const sfdm::ICodeReader &reader, const sfdm::ImageView &view,
+                                     sfdm::DecodeOptions options) {
+        const auto allResults = reader.decode(view, options);
+        REQUIRE(allResults.size() >= 2);
+        const auto lastText = allResults.back().text;
+
+        options.maximumNumberOfCodesToDetect = 1;
+        options.expectedPayloads = std::make_shared<sfdm::ExpectedPayloads>(std::vector{lastText});
+        const auto results = reader.decode(view, options);
+        CHECK(std::ranges::find(results, lastText, &sfdm::DecodeResult::text) != results.end());
+    }
+} // namespace
+
+TEST_CASE("Expected payload matching") {
+    sfdm::ExpectedPayloads expected({"ABC"});
+    expected.addPattern("LOT-[0-9]+");
+    REQUIRE(expected.size() == 2);
+
+    CHECK(expected.matches(0, "ABC"));
+    CHECK_FALSE(expected.matches(0, "ABCD"));
+    CHECK(expected.matches(1, "LOT-42"));
+    // the pattern has to match the whole payload
+    CHECK_FALSE(expected.matches(1, "LOT-42x"));
+    CHECK_THROWS(expected.addPattern("("));
+}
+
+TEST_CASE("Overlapping expected payloads") {
+    auto expected = std::make_shared<sfdm::ExpectedPayloads>();
+    expected->addPattern("LOT-[0-9]+");
+    expected->addText("LOT-1");
+    const sfdm::DecodeOptions options{.expectedPayloads = expected};
+
+    SECTION("Pattern taken by the text") {
+        // LOT-1 takes the pattern first and has to move to its text item for LOT-2
+        sfdm::detail::StopCondition stopCondition(options);
+        CHECK(stopCondition.add("LOT-1"));
+        CHECK_FALSE(stopCondition.isReached());
+        CHECK(stopCondition.add("LOT-2"));
+        CHECK(stopCondition.isReached());
+    }
+    SECTION("Repeated text") {
+        sfdm::detail::StopCondition stopCondition(options);
+        CHECK(stopCondition.add("LOT-1"));
+        CHECK(stopCondition.add("LOT-1"));
+        CHECK(stopCondition.isReached());
+        CHECK_FALSE(stopCondition.add("LOT-3"));
+    }
+    SECTION("Replace") {
+        sfdm::detail::StopCondition stopCondition(options);
+        CHECK(stopCondition.add("LOT-2"));
+        CHECK(stopCondition.add("LOT-1"));
+        stopCondition.replace("LOT-2", "LOT-1");
+        CHECK(stopCondition.isReached());
+        stopCondition.replace("LOT-1", "ABC");
+        CHECK_FALSE(stopCondition.isReached());
+        CHECK(stopCondition.add("LOT-3"));
+        CHECK(stopCondition.isReached());
+    }
+}
+
+TEST_CASE("Decoding stops once the expected payloads were found") {
+    const auto annotated = getAnnotatedImage(2);
+    const auto view = toView(annotated.image);
+    // without timeout, so both decode calls find the codes in the same order
+    const sfdm::DecodeOptions options{.timeoutMSec = 0, .maximumNumberOfCodesToDetect = annotated.texts.size()};
+
+    SECTION("libdmtx") {
+        const sfdm::LibdmtxCodeReader reader;
+        checkStopsAtExpectedPayload(reader, view, options);
+
+        // the search ends right after the expected code
+        const auto allResults = reader.decode(view, options);
+        auto expectedOptions = options;
+        expectedOptions.expectedPayloads = std::make_shared<sfdm::ExpectedPayloads>(std::vector{allResults[1].text});
+        CHECK(reader.decode(view, expectedOptions).size() == 2);
+    }
+    SECTION("ZXing") { checkStopsAtExpectedPayload(sfdm::ZXingCodeReader{}, view, options); }
+    SECTION("Combined") { checkStopsAtExpectedPayload(sfdm::LibdmtxZXingCombinedCodeReader{}, view, options); }
+}
@@ -0,0 +1,93 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sfdm/sfdm.hpp>
+
+#include "test_utils.hpp"
+
+namespace {
+    cv::Mat checkerboard(int size, int fieldSize) {
+        cv::Mat image(size, size, CV_8UC1);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                image.at<uint8_t>(y, x) = (x / fieldSize + y / fieldSize) % 2 ? 255 : 0;
+            }
+        }
+        return image;
+    }
+} // namespace
+
+TEST_CASE("Image quality") {
+    SECTION("Uniform image") {
+        const cv::Mat image(64, 64, CV_8UC1, cv::Scalar(128));
+        const auto quality = sfdm::measureImageQuality(toView(image));
+        CHECK(quality.sharpness == 0.0);
+        CHECK(quality.contrast == 0.0);
+        CHECK(quality.brightness == 128.0);
+        CHECK(quality.overexposedFraction == 0.0);
+        CHECK(quality.underexposedFraction == 0.0);
+    }
+    SECTION("Saturated image") {
+        const cv::Mat image(64, 64, CV_8UC1, cv::Scalar(255));
+        const auto quality = sfdm::measureImageQuality(toView(image));
+        CHECK(quality.overexposedFraction == 1.0);
+        CHECK(quality.underexposedFraction == 0.0);
+    }
+    SECTION("Sharp edges") {
+        const auto image = checkerboard(64, 3);
+        const auto quality = sfdm::measureImageQuality(toView(image), 1);
+        CHECK(quality.sharpness > 1000.0);
+        CHECK(quality.contrast == 255.0);
+    }
+    SECTION("Sample step 0") {
+        const cv::Mat image(8, 8, CV_8UC1, cv::Scalar(0));
+        CHECK_THROWS(sfdm::measureImageQuality(toView(image), 0));
+    }
+}
+
+TEST_CASE("Quality gate") {
+    const sfdm::ImageQuality quality{.sharpness = 50.0, .contrast = 100.0, .overexposedFraction = 0.2};
+    CHECK(sfdm::evaluateQualityGate(quality, {}) == sfdm::QualityAction::Decode);
+    CHECK(sfdm::evaluateQualityGate(quality, {.minSharpness = 100.0}) == sfdm::QualityAction::Reject);
+    CHECK(sfdm::evaluateQualityGate(quality, {.maxOverexposedFraction = 0.1,
+                                              .onFailure = sfdm::QualityAction::Downgrade}) ==
+          sfdm::QualityAction::Downgrade);
+
+    SECTION("Downgraded options") {
+        const cv::Mat image(64, 64, CV_8UC1, cv::Scalar(128));
+        sfdm::DecodeOptions options{.timeoutMSec = 0};
+        options.qualityGate = sfdm::QualityGate{.minContrast = 10.0, .onFailure = sfdm::QualityAction::Downgrade};
+        sfdm::DecodeReport report;
+        const auto gatedOptions = sfdm::applyQualityGate(toView(image), options, report);
+        REQUIRE(gatedOptions);
+        CHECK_FALSE(gatedOptions->qualityGate);
+        CHECK(gatedOptions->timeoutMSec == options.qualityGate->downgradedTimeoutMSec);
+        CHECK(gatedOptions->maximumEffortLevels == options.qualityGate->downgradedEffortLevels);
+        CHECK(report.qualityAction == sfdm::QualityAction::Downgrade);
+    }
+}
+
+TEST_CASE("Decoding with quality gate") {
+    const auto annotated = getAnnotatedImage();
+
+    const sfdm::ZXingCodeReader reader;
+    SECTION("Rejected frame") {
+        const cv::Mat blank(annotated.image.rows, annotated.image.cols, CV_8UC1, cv::Scalar(128));
+        auto options = reader.getDefaultOptions();
+        options.qualityGate = sfdm::QualityGate{.minContrast = 10.0};
+        sfdm::DecodeReport report;
+        CHECK(reader.decode(toView(blank), options, report).empty());
+        CHECK(report.qualityAction == sfdm::QualityAction::Reject);
+        REQUIRE(report.quality);
+        CHECK(report.quality->contrast == 0.0);
+    }
+    SECTION("Accepted frame") {
+        auto options = reader.getDefaultOptions();
+        options.qualityGate = sfdm::QualityGate{};
+        sfdm::DecodeReport report;
+        const auto results = reader.decode(toView(annotated.image), options, report);
+        CHECK(results == reader.decode(toView(annotated.image)));
+        CHECK_FALSE(results.empty());
+        CHECK(report.qualityAction == sfdm::QualityAction::Decode);
+        CHECK(report.quality);
+    }
+}
@@ -0,0 +1,108 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sfdm/sfdm.hpp>
+
+#include <algorithm>
+
+#include "test_utils.hpp"
+
+namespace {
+    constexpr size_t side = 1000;
+    constexpr size_t pixelCount = side * side;
+
+    sfdm::DecodeOptions withLimit(size_t limit) {
+        sfdm::DecodeOptions options;
+        options.memoryLimit = limit;
+        return options;
+    }
+} // namespace
+
+TEST_CASE("Memory estimates") {
+    std::vector<uint8_t> pixels(pixelCount, 255);
+    const sfdm::ImageView image{side, side, pixels.data()};
+    const sfdm::LibdmtxCodeReader libdmtxReader;
+
+    SECTION("Whole image") {
+        const auto usage = libdmtxReader.estimateMemoryUsage(image, {});
+        CHECK(usage.libdmtxCache == pixelCount);
+        CHECK(usage.peak == pixelCount);
+        CHECK(usage.imageCopies == 0);
+        CHECK_FALSE(usage.striped);
+        CHECK(usage.withinLimit);
+    }
+    SECTION("Strips at full resolution") {
+        const auto usage = libdmtxReader.estimateMemoryUsage(image, withLimit(600'000));
+        CHECK(usage.striped);
+        CHECK_FALSE(usage.downscaled);
+        CHECK(usage.peak == 600'000);
+    }
+    SECTION("Downscaled") {
+        // strips of 400 rows are too small for the default overlap, the image is scanned at half the size
+        const auto usage = libdmtxReader.estimateMemoryUsage(image, withLimit(400'000));
+        CHECK(usage.downscaled);
+        CHECK(usage.imageCopies == pixelCount / 4);
+        CHECK(usage.peak <= 400'000);
+        CHECK(usage.withinLimit);
+    }
+    SECTION("Limit too small") {
+        CHECK_FALSE(libdmtxReader.estimateMemoryUsage(image, withLimit(1000)).withinLimit);
+    }
+    SECTION("Combined backends are serialized") {
+        const sfdm::LibdmtxZXingCombinedCodeReader reader;
+        const auto concurrent = reader.estimateMemoryUsage(image, {});
+        CHECK_FALSE(concurrent.serialized);
+        CHECK(concurrent.peak > 2 * pixelCount);
+
+        const auto serialized = reader.estimateMemoryUsage(image, withLimit(3 * pixelCount / 2));
+        CHECK(serialized.serialized);
+        CHECK(serialized.libdmtxCache == pixelCount);
+        CHECK(serialized.peak <= 3 * pixelCount / 2);
+    }
+    SECTION("Image variants are serialized") {
+        const sfdm::VariantRacingCodeReader reader(sfdm::createCodeReader({sfdm::ReaderBackend::Libdmtx}));
+        const auto concurrent = reader.estimateMemoryUsage(image, {});
+        CHECK(concurrent.peak == 3 * pixelCount);
+        CHECK(concurrent.imageCopies == pixelCount);
+
+        const auto serialized = reader.estimateMemoryUsage(image, withLimit(2 * pixelCount));
+        CHECK(serialized.serialized);
+        CHECK_FALSE(serialized.striped);
+        CHECK(serialized.peak == 2 * pixelCount);
+    }
+}
+
+TEST_CASE("Memory limits") {
+    const auto annotated = getAnnotatedImage();
+
+    // the image four times below each other, so the strips are high enough for the default overlap
+    cv::Mat twice;
+    cv::Mat stacked;
+    cv::vconcat(annotated.image, annotated.image, twice);
+    cv::vconcat(twice, twice, stacked);
+    const auto image = toView(stacked);
+
+    const sfdm::LibdmtxCodeReader reader;
+    const sfdm::DecodeOptions options{.timeoutMSec = 0};
+    const auto expected = reader.decode(image, options);
+    REQUIRE_FALSE(expected.empty());
+
+    SECTION("Strips find the codes of the whole image") {
+        auto limitedOptions = options;
+        limitedOptions.memoryLimit = image.width * image.height / 2;
+        sfdm::DecodeReport report;
+        const auto results = reader.decode(image, limitedOptions, report);
+        CHECK(report.memory.striped);
+        CHECK(report.memory.peak <= *limitedOptions.memoryLimit);
+        for (const auto &result: expected) {
+            CAPTURE(result.text);
+            CHECK(std::ranges::find(results, result.text, &sfdm::DecodeResult::text) != results.end());
+        }
+    }
+    SECTION("Nothing is decoded above the limit") {
+        auto limitedOptions = options;
+        limitedOptions.memoryLimit = 1000;
+        sfdm::DecodeReport report;
+        CHECK(reader.decode(image, limitedOptions, report).empty());
+        CHECK_FALSE(report.memory.withinLimit);
+    }
+}
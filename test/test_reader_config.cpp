@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include <string>
+
+#include <sfdm/sfdm.hpp>
+
+TEST_CASE("Reader config") {
+    SECTION("Round trip") {
+        const sfdm::ReaderConfig config{sfdm::ReaderBackend::Libdmtx, 50, false};
+        std::stringstream stream;
+        sfdm::writeReaderConfig(stream, config);
+        REQUIRE(sfdm::readReaderConfig(stream) == config);
+
+        const sfdm::ReaderConfig variants{.tryInverted = true, .tryMirrored = true};
+        std::stringstream variantStream;
+        sfdm::writeReaderConfig(variantStream, variants);
+        REQUIRE(sfdm::readReaderConfig(variantStream) == variants);
+    }
+    SECTION("Decode options round trip") {
+        sfdm::DecodeOptions options{.timeoutMSec = 80, .maximumNumberOfCodesToDetect = 3};
+        options.hints.symbolSizes = {{16, 16}, {12, 36}};
+        options.hints.shape = sfdm::SymbolShape::Square;
+        options.hints.minModuleSize = 4;
+        options.maximumEffortLevels = 2;
+        options.qualityGate = sfdm::QualityGate{.minSharpness = 0.25, .onFailure = sfdm::QualityAction::Downgrade};
+        std::stringstream stream;
+        sfdm::writeDecodeOptions(stream, options);
+
+        sfdm::DecodeOptions read;
+        std::string line;
+        while (std::getline(stream, line)) {
+            const auto separator = line.find('=');
+            REQUIRE(sfdm::readDecodeOption(read, line.substr(0, separator), line.substr(separator + 1)));
+        }
+        REQUIRE(read.timeoutMSec == 80);
+        REQUIRE(read.maximumNumberOfCodesToDetect == 3);
+        REQUIRE(read.hints.symbolSizes.size() == 2);
+        REQUIRE(read.hints.symbolSizes[1].rows == 12);
+        REQUIRE(read.hints.symbolSizes[1].columns == 36);
+        REQUIRE(read.hints.shape == sfdm::SymbolShape::Square);
+        REQUIRE(read.hints.minModuleSize == 4);
+        REQUIRE(!read.hints.maxModuleSize);
+        REQUIRE(read.maximumEffortLevels == 2);
+        REQUIRE(read.qualityGate);
+        REQUIRE(read.qualityGate->minSharpness == 0.25);
+        REQUIRE(read.qualityGate->onFailure == sfdm::QualityAction::Downgrade);
+
+        sfdm::DecodeOptions unchanged;
+        REQUIRE(!sfdm::readDecodeOption(unchanged, "decode_ms", "12.5"));
+        REQUIRE_THROWS(sfdm::readDecodeOption(unchanged, "shape", "round"));
+    }
+    SECTION("Comments and missing keys") {
+        std::stringstream stream{"# tuned for line 3\n\nbackend = zxing\n"};
+        const auto config = sfdm::readReaderConfig(stream);
+        REQUIRE(config.backend == sfdm::ReaderBackend::ZXing);
+        REQUIRE(config.timeoutMSec == sfdm::ReaderConfig{}.timeoutMSec);
+    }
+    SECTION("Invalid values") {
+        std::stringstream unknownBackend{"backend=opencv\n"};
+        REQUIRE_THROWS(sfdm::readReaderConfig(unknownBackend));
+        std::stringstream invalidTimeout{"timeout=-1\n"};
+        REQUIRE_THROWS(sfdm::readReaderConfig(invalidTimeout));
+        std::stringstream unknownKey{"speed=fast\n"};
+        REQUIRE_THROWS(sfdm::readReaderConfig(unknownKey));
+    }
+    SECTION("Create reader") {
+        const auto reader = sfdm::createCodeReader({sfdm::ReaderBackend::Combined, 100, false});
+        REQUIRE(reader->getTimeout() == 100);
+    }
+}
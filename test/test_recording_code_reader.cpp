@@ -0,0 +1,88 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sfdm/sfdm.hpp>
+
+#include <fstream>
+
+#include "test_utils.hpp"
+
+namespace {
+    size_t countCaptures(const std::filesystem::path &directory) {
+        return static_cast<size_t>(std::ranges::count_if(std::filesystem::directory_iterator(directory),
+                                                         [](const auto &entry) {
+                                                             return entry.path().extension() == ".txt";
+                                                         }));
+    }
+} // namespace
+
+TEST_CASE("Recording slow frames") {
+    const auto annotated = getAnnotatedImage();
+    const auto view = toView(annotated.image);
+    const auto directory = std::filesystem::temp_directory_path() / "sfdm_recording_test";
+    std::filesystem::remove_all(directory);
+
+    const sfdm::ReaderConfig readerConfig{sfdm::ReaderBackend::ZXing};
+
+    SECTION("Frames are written into a ring") {
+        std::vector<sfdm::DecodeResult> results;
+        {
+            // every frame exceeds a threshold of 0
+            sfdm::RecordingCodeReader reader(sfdm::createCodeReader(readerConfig),
+                                             {directory, std::chrono::milliseconds{0}, false, 2, 4, readerConfig});
+            for (int i = 0; i < 3; ++i) {
+                results = reader.decode(view);
+            }
+        }
+        // the third frame overwrote the first one
+        CHECK(countCaptures(directory) == 2);
+        CHECK(sfdm::loadReaderConfig(directory / "0.cfg") == readerConfig);
+
+        std::ifstream metadata(directory / "0.txt");
+        std::string line;
+        std::getline(metadata, line);
+        CHECK(line == "sequence=2");
+        std::getline(metadata, line);
+        CHECK(line == "reason=latency");
+
+        std::ifstream image(directory / "0.pgm", std::ios::binary);
+        std::string magic;
+        size_t width{};
+        size_t height{};
+        image >> magic >> width >> height;
+        CHECK(magic == "P5");
+        CHECK(width == view.width);
+        CHECK(height == view.height);
+    }
+    SECTION("Fast frames with all codes are not recorded") {
+        const auto codeCount = sfdm::createCodeReader(readerConfig)->decode(view).size();
+        REQUIRE(codeCount > 0);
+        {
+            // missing codes are only recorded on request, the default maximum of 255 would record every frame
+            sfdm::RecordingCodeReader defaultReader(sfdm::createCodeReader(readerConfig),
+                                                    {directory, std::chrono::milliseconds{60000}});
+            (void) defaultReader.decode(view);
+        }
+        CHECK(countCaptures(directory) == 0);
+        {
+            sfdm::RecordingCodeReader reader(sfdm::createCodeReader(readerConfig),
+                                             {directory, std::chrono::milliseconds{60000}, true});
+            auto options = reader.getDefaultOptions();
+            options.maximumNumberOfCodesToDetect = codeCount;
+            CHECK(reader.decode(view, options).size() == codeCount);
+
+            // one code more than the image has
+            options.maximumNumberOfCodesToDetect = codeCount + 1;
+            sfdm::DecodeResultBuffer buffer;
+            reader.decode(view, options, buffer);
+            CHECK(buffer.size() == codeCount);
+        }
+        CHECK(countCaptures(directory) == 1);
+        std::ifstream metadata(directory / "0.txt");
+        std::string line;
+        std::getline(metadata, line);
+        std::getline(metadata, line);
+        CHECK(line == "reason=missing_codes");
+        CHECK_FALSE(std::filesystem::exists(directory / "0.cfg"));
+    }
+    std::filesystem::remove_all(directory);
+}
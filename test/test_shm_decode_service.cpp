@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <sfdm/sfdm.hpp>
+#include <sfdm/shm_decode_service.hpp>
+
+#include "shm_ring.hpp"
+#include "test_utils.hpp"
+
+namespace {
+    constexpr std::chrono::milliseconds waitTimeout{10000};
+
+    sfdm::ReaderConfig getReaderConfig() { return {sfdm::ReaderBackend::Libdmtx, 100, false}; }
+} // namespace
+
+TEST_CASE("Shared memory decode service") {
+    const std::string name = "/sfdm_test_" + std::to_string(getpid());
+    sfdm::shm::ShmDecodeServer server({name, 2, 4096 * 4096, 32, 1024, 2},
+                                      [] { return sfdm::createCodeReader(getReaderConfig()); });
+    sfdm::shm::ShmDecodeClient client(name);
+
+    SECTION("Slots are reused") {
+        for (int i = 0; i < 5; ++i) {
+            const auto slot = client.acquireFrame(waitTimeout);
+            REQUIRE(slot);
+            std::memset(slot->pixels, 255, 640 * 480);
+            client.submitFrame(*slot, 640, 480, 1);
+            const auto results = client.waitForResults(*slot, waitTimeout);
+            REQUIRE(results);
+            REQUIRE(results->empty());
+        }
+    }
+
+    SECTION("All slots in use") {
+        const auto first = client.acquireFrame(waitTimeout);
+        const auto second = client.acquireFrame(waitTimeout);
+        REQUIRE(first);
+        REQUIRE(second);
+        REQUIRE_FALSE(client.acquireFrame(std::chrono::milliseconds{0}));
+        client.releaseFrame(*first);
+        const auto third = client.acquireFrame(std::chrono::milliseconds{0});
+        REQUIRE(third);
+        REQUIRE(third->index == first->index);
+        client.releaseFrame(*second);
+        client.releaseFrame(*third);
+    }
+
+    SECTION("Frame too large") {
+        const auto slot = client.acquireFrame(waitTimeout);
+        REQUIRE(slot);
+        REQUIRE_THROWS(client.submitFrame(*slot, 4097, 4096, 1));
+        client.releaseFrame(*slot);
+    }
+
+    SECTION("Server rejects frames larger than the slot") {
+        // a client, that bypasses the size check of submitFrame, writes the slot header itself
+        const int fd = shm_open(name.c_str(), O_RDWR, 0);
+        REQUIRE(fd >= 0);
+        struct stat status{};
+        REQUIRE(fstat(fd, &status) == 0);
+        const auto size = static_cast<size_t>(status.st_size);
+        void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        REQUIRE(address != MAP_FAILED);
+        const sfdm::shm::RingMapping mapping(name, address, size, false);
+
+        const auto slot = client.acquireFrame(waitTimeout);
+        REQUIRE(slot);
+        auto &slotHeader = mapping.slot(slot->index);
+        slotHeader.width = 65535;
+        slotHeader.height = 65535;
+        slotHeader.maximumNumberOfCodes = 1;
+        slotHeader.state.store(static_cast<uint32_t>(sfdm::shm::SlotState::Submitted), std::memory_order_release);
+        sem_post(&mapping.header().submittedSlots);
+        REQUIRE_THROWS(client.waitForResults(*slot, waitTimeout));
+    }
+
+    SECTION("Same results as local decoding") {
+        const auto data = readDataMatrixFile("../_deps/images-src/annotations.txt");
+        const auto localReader = sfdm::createCodeReader(getReaderConfig());
+        for (const auto &[image, fileName]: getImagesFromFiles()) {
+            const auto it = data.find(fileName);
+            if (it == data.end()) {
+                continue;
+            }
+            CAPTURE(fileName);
+            const auto slot = client.acquireFrame(waitTimeout);
+            REQUIRE(slot);
+            const auto size = static_cast<size_t>(image.cols) * static_cast<size_t>(image.rows);
+            REQUIRE(size <= slot->capacity);
+            std::memcpy(slot->pixels, image.data, size);
+            client.submitFrame(*slot, image.cols, image.rows, it->second.size());
+
+            localReader->setMaximumNumberOfCodesToDetect(it->second.size());
+            const auto expected = localReader->decode(
+                    {static_cast<size_t>(image.cols), static_cast<size_t>(image.rows), image.data});
+
+            const auto results = client.waitForResults(*slot, waitTimeout);
+            REQUIRE(results);
+            REQUIRE(*results == expected);
+        }
+    }
+}
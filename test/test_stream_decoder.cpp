@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sfdm/sfdm.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include "test_utils.hpp"
+
+namespace {
+    sfdm::StreamFrame toFrame(const cv::Mat &image) {
+        const auto width = static_cast<size_t>(image.cols);
+        const auto height = static_cast<size_t>(image.rows);
+        return {width, height, std::vector<uint8_t>(image.data, image.data + width * height)};
+    }
+
+    struct CollectedResults {
+        std::mutex mutex;
+        std::vector<sfdm::StreamResult> results;
+
+        sfdm::StreamDecoder::ResultCallback callback() {
+            return [this](sfdm::StreamResult result) {
+                std::lock_guard lock(mutex);
+                results.emplace_back(std::move(result));
+            };
+        }
+    };
+} // namespace
+
+TEST_CASE("Stream decoder under overload") {
+    const auto image = getAnnotatedImage().image;
+    // without timeout libdmtx is much slower than submitting, so the queue overflows
+    const sfdm::LibdmtxCodeReader reader;
+    constexpr uint64_t frameCount = 20;
+
+    SECTION("Drop newest") {
+        CollectedResults collected;
+        sfdm::StreamDecoder decoder(reader, {.queueCapacity = 2, .policy = sfdm::OverloadPolicy::DropNewest},
+                                    {.timeoutMSec = 0}, collected.callback());
+        for (uint64_t i = 0; i < frameCount; ++i) {
+            (void) decoder.submit(toFrame(image));
+        }
+        decoder.close();
+
+        const auto statistics = decoder.getStatistics();
+        CHECK(statistics.submittedFrames == frameCount);
+        CHECK(statistics.droppedFrames > 0);
+        CHECK(statistics.decodedFrames + statistics.droppedFrames == frameCount);
+        CHECK(statistics.maximumQueueDepth <= 2);
+        CHECK(statistics.queueDepth == 0);
+        CHECK(collected.results.size() == statistics.decodedFrames);
+        CHECK(collected.results.front().sequence == 0);
+        CHECK_FALSE(collected.results.front().results.empty());
+    }
+    SECTION("Latest only") {
+        CollectedResults collected;
+        sfdm::StreamDecoder decoder(reader, {.policy = sfdm::OverloadPolicy::LatestOnly}, {.timeoutMSec = 0},
+                                    collected.callback());
+        for (uint64_t i = 0; i < frameCount; ++i) {
+            CHECK(decoder.submit(toFrame(image)));
+        }
+        decoder.close();
+
+        const auto statistics = decoder.getStatistics();
+        CHECK(statistics.maximumQueueDepth == 1);
+        CHECK(statistics.decodedFrames + statistics.droppedFrames == frameCount);
+        // the latest frame is never dropped
+        REQUIRE_FALSE(collected.results.empty());
+        CHECK(collected.results.back().sequence == frameCount - 1);
+        CHECK(statistics.maximumLatency >= statistics.meanLatency);
+    }
+}
+
+TEST_CASE("Stream decoder with several producers") {
+    const sfdm::LibdmtxCodeReader reader;
+    constexpr uint64_t producerCount = 4;
+    constexpr uint64_t framesPerProducer = 25;
+    constexpr auto frameCount = producerCount * framesPerProducer;
+    CollectedResults collected;
+    // room for every frame, so none is dropped
+    sfdm::StreamDecoder decoder(reader, {.queueCapacity = frameCount, .workerCount = 2}, {.timeoutMSec = 0},
+                                collected.callback());
+    // Catch assertions are not thread safe, the producers only count
+    std::atomic<uint64_t> rejectedFrames{0};
+    {
+        std::vector<std::jthread> producers;
+        for (uint64_t i = 0; i < producerCount; ++i) {
+            producers.emplace_back([&] {
+                for (uint64_t frame = 0; frame < framesPerProducer; ++frame) {
+                    if (!decoder.submit({64, 64, std::vector<uint8_t>(64 * 64, 255)})) {
+                        ++rejectedFrames;
+                    }
+                }
+            });
+        }
+    }
+    decoder.close();
+    CHECK(rejectedFrames == 0);
+
+    std::vector<uint64_t> sequences;
+    std::ranges::transform(collected.results, std::back_inserter(sequences), &sfdm::StreamResult::sequence);
+    std::ranges::sort(sequences);
+    std::vector<uint64_t> expected(frameCount);
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK(sequences == expected);
+}
+
+TEST_CASE("Stream decoder drops expired frames") {
+    const auto image = getAnnotatedImage().image;
+    const sfdm::ZXingCodeReader reader;
+    CollectedResults collected;
+    sfdm::StreamDecoder decoder(reader, {.maximumLatency = std::chrono::milliseconds{10}}, reader.getDefaultOptions(),
+                                collected.callback());
+    auto frame = toFrame(image);
+    frame.captureTime = std::chrono::steady_clock::now() - std::chrono::seconds{1};
+    CHECK(decoder.submit(std::move(frame)));
+    decoder.close();
+
+    CHECK(decoder.getStatistics().expiredFrames == 1);
+    CHECK(collected.results.empty());
+    CHECK_FALSE(decoder.submit(toFrame(image)));
+}
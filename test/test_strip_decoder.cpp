@@ -0,0 +1,59 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sfdm/sfdm.hpp>
+
+#include "test_utils.hpp"
+
+namespace {
+    bool isAt(const sfdm::DecodeResult &result, const std::string &text, const sfdm::CodePosition &position) {
+        return result.text == text && isNear(result.position.bottomLeft, position.bottomLeft) &&
+               isNear(result.position.topRight, position.topRight);
+    }
+} // namespace
+
+TEST_CASE("Strip decoding") {
+    const auto annotated = getAnnotatedImage();
+
+    // the image twice below each other, every code has to be found once in each copy
+    cv::Mat image;
+    cv::vconcat(annotated.image, annotated.image, image);
+    const auto height = static_cast<size_t>(annotated.image.rows);
+    const auto width = static_cast<size_t>(image.cols);
+    const auto rows = static_cast<size_t>(image.rows);
+
+    // without timeout, so every strip is searched completely
+    const sfdm::LibdmtxCodeReader reader;
+    const sfdm::DecodeOptions options{.timeoutMSec = 0};
+    const auto expected = reader.decode(toView(annotated.image), options);
+    REQUIRE_FALSE(expected.empty());
+
+    sfdm::StripDecoder decoder(reader, {width, height, height / 2}, options);
+    std::vector<sfdm::DecodeResult> results;
+    constexpr size_t blockRows = 97;
+    for (size_t row = 0; row < rows; row += blockRows) {
+        const auto rowCount = std::min(blockRows, rows - row);
+        auto blockResults = decoder.push(image.ptr(static_cast<int>(row)), rowCount);
+        results.insert(results.end(), blockResults.begin(), blockResults.end());
+    }
+    REQUIRE(decoder.getRowCount() == rows);
+    auto lastResults = decoder.finish();
+    results.insert(results.end(), lastResults.begin(), lastResults.end());
+
+    CHECK(results.size() == 2 * expected.size());
+    for (const auto &result: expected) {
+        CAPTURE(result.text);
+        auto lower = result.position;
+        for (auto *point: {&lower.bottomLeft, &lower.topLeft, &lower.topRight, &lower.bottomRight}) {
+            point->y += static_cast<uint32_t>(height);
+        }
+        CHECK(std::ranges::count_if(results, [&](const auto &r) { return isAt(r, result.text, result.position); }) ==
+              1);
+        CHECK(std::ranges::count_if(results, [&](const auto &r) { return isAt(r, result.text, lower); }) == 1);
+    }
+}
+
+TEST_CASE("Invalid strip layouts") {
+    const sfdm::ZXingCodeReader reader;
+    CHECK_THROWS(sfdm::StripDecoder(reader, {0, 100, 10}));
+    CHECK_THROWS(sfdm::StripDecoder(reader, {100, 100, 100}));
+}
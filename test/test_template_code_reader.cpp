@@ -0,0 +1,68 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sfdm/sfdm.hpp>
+
+#include "test_utils.hpp"
+
+TEST_CASE("Template decoding") {
+    const auto data = readDataMatrixFile("../_deps/images-src/annotations.txt");
+
+    for (const auto &[image, fileName]: getImagesFromFiles()) {
+        const auto it = data.find(fileName);
+        if (it == data.end()) {
+            continue;
+        }
+        const sfdm::ImageView view{static_cast<size_t>(image.cols), static_cast<size_t>(image.rows), image.data};
+
+        SECTION(fileName) {
+            // calibrate on the image itself, the template reader has to find the same codes in their slots
+            sfdm::LibdmtxCodeReader calibrationReader;
+            calibrationReader.setTimeout(100);
+            calibrationReader.setMaximumNumberOfCodesToDetect(it->second.size());
+            const auto calibration = calibrationReader.decode(view);
+            const auto layout = sfdm::CodeLayout::fromCalibration(calibration, 20);
+            REQUIRE(layout.slots.size() == calibration.size());
+
+            auto backend = std::make_unique<sfdm::LibdmtxCodeReader>();
+            backend->setTimeout(100);
+            const sfdm::TemplateCodeReader reader(std::move(backend), layout);
+            const auto slotResults = reader.decodeSlots(view);
+            REQUIRE(slotResults.size() == layout.slots.size());
+
+            for (const auto &slotResult: slotResults) {
+                CAPTURE(slotResult.slotIndex);
+                REQUIRE(slotResult.result);
+                const auto expected = std::ranges::find(calibration, layout.slots[slotResult.slotIndex].expectedPosition,
+                                                        &sfdm::DecodeResult::position);
+                REQUIRE(expected != calibration.end());
+                CHECK(slotResult.result->text == expected->text);
+            }
+        }
+    }
+
+    SECTION("Empty slots") {
+        std::vector<uint8_t> pixels(640 * 480, 255);
+        const sfdm::ImageView view{640, 480, pixels.data()};
+        const sfdm::CodeLayout layout{{{{{10, 110}, {10, 10}, {110, 10}, {110, 110}}, 20},
+                                       {{{300, 400}, {300, 300}, {400, 300}, {400, 400}}, 20}}};
+        const sfdm::TemplateCodeReader reader(std::make_unique<sfdm::LibdmtxCodeReader>(), layout);
+        const auto slotResults = reader.decodeSlots(view);
+        REQUIRE(slotResults.size() == 2);
+        CHECK_FALSE(slotResults[0].result);
+        CHECK_FALSE(slotResults[1].result);
+        CHECK(reader.decode(view).empty());
+    }
+    SECTION("Errors of a slot are rethrown") {
+        std::vector<uint8_t> pixels(640 * 480, 255);
+        const sfdm::ImageView view{640, 480, pixels.data()};
+        sfdm::CodeLayout layout;
+        for (uint32_t x = 0; x < 600; x += 100) {
+            layout.slots.push_back({{{x, 110}, {x, 10}, {x + 90, 10}, {x + 90, 110}}, 5});
+        }
+        const sfdm::TemplateCodeReader reader(std::make_unique<sfdm::LibdmtxCodeReader>(), layout, 3);
+        sfdm::DecodeOptions options;
+        // libdmtx rejects the hint on every slot
+        options.hints.symbolSizes = {{11, 11}};
+        CHECK_THROWS_AS(reader.decodeSlots(view, options), std::runtime_error);
+    }
+}
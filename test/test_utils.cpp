@@ -6,6 +6,7 @@
 #include <map>
 #include <ranges>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -82,3 +83,28 @@ std::vector<std::pair<cv::Mat, std::string>> getImagesFromFiles() {
     }
     return result;
 }
+
+AnnotatedImage getAnnotatedImage(size_t minimumCodeCount) {
+    const auto data = readDataMatrixFile("../_deps/images-src/annotations.txt");
+    // same order as getImagesFromFiles, but only the returned image is loaded
+    for (const auto &entry: std::filesystem::directory_iterator("../_deps/images-src")) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".jpg") {
+            continue;
+        }
+        auto fileName = entry.path().stem().string();
+        if (const auto it = data.find(fileName); it != data.end() && it->second.size() >= minimumCodeCount) {
+            return {get_image(entry), std::move(fileName), it->second};
+        }
+    }
+    throw std::runtime_error{"No annotated test image found!"};
+}
+
+sfdm::ImageView toView(const cv::Mat &image) {
+    return {static_cast<size_t>(image.cols), static_cast<size_t>(image.rows), image.data};
+}
+
+bool isNear(const sfdm::Point &p1, const sfdm::Point &p2) {
+    const auto dx = static_cast<int64_t>(p1.x) - p2.x;
+    const auto dy = static_cast<int64_t>(p1.y) - p2.y;
+    return dx * dx + dy * dy <= 25;
+}
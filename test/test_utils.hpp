@@ -3,9 +3,17 @@
 #include <filesystem>
 #include <map>
 #include <opencv2/opencv.hpp>
+#include <sfdm/decode_result.hpp>
+#include <sfdm/image_view.hpp>
 #include <string>
 #include <vector>
 
+struct AnnotatedImage {
+    cv::Mat image;
+    std::string fileName;
+    std::vector<std::string> texts;
+};
+
 int extraElementsCount(const std::vector<std::string> &a, const std::vector<std::string> &requirement);
 
 std::map<std::string, std::vector<std::string>> readDataMatrixFile(const std::string &filename);
@@ -13,3 +21,11 @@ std::map<std::string, std::vector<std::string>> readDataMatrixFile(const std::st
 cv::Mat get_image(const std::filesystem::directory_entry &entry);
 
 std::vector<std::pair<cv::Mat, std::string>> getImagesFromFiles();
+
+// the first test image with at least minimumCodeCount annotated codes, throws if there is none
+AnnotatedImage getAnnotatedImage(size_t minimumCodeCount = 1);
+
+sfdm::ImageView toView(const cv::Mat &image);
+
+// at most 5 pixels apart
+bool isNear(const sfdm::Point &p1, const sfdm::Point &p2);
@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sfdm/sfdm.hpp>
+
+#include <algorithm>
+
+#include "test_utils.hpp"
+
+namespace {
+    std::vector<std::string> sortedTexts(const std::vector<sfdm::DecodeResult> &results) {
+        std::vector<std::string> texts;
+        std::ranges::transform(results, std::back_inserter(texts), &sfdm::DecodeResult::text);
+        std::ranges::sort(texts);
+        return texts;
+    }
+
+    uint32_t centerX(const sfdm::CodePosition &position) {
+        return (position.bottomLeft.x + position.topLeft.x + position.topRight.x + position.bottomRight.x) / 4;
+    }
+
+    uint32_t centerY(const sfdm::CodePosition &position) {
+        return (position.bottomLeft.y + position.topLeft.y + position.topRight.y + position.bottomRight.y) / 4;
+    }
+
+    double totalHeat(const sfdm::CodeLocationPrior &prior) {
+        double heat = 0.0;
+        for (size_t row = 0; row < prior.getRows(); ++row) {
+            for (size_t column = 0; column < prior.getColumns(); ++column) {
+                heat += prior.getHeat(column, row);
+            }
+        }
+        return heat;
+    }
+} // namespace
+
+TEST_CASE("Image variants") {
+    std::vector<uint8_t> pixels{0, 10, 20, 30, 40, 255};
+    const sfdm::ImageView image{3, 2, pixels.data()};
+    std::vector<uint8_t> scratch;
+
+    SECTION("Normal images are not copied") {
+        CHECK(sfdm::createImageVariant(image, sfdm::ImageVariant::Normal, scratch).data == pixels.data());
+        CHECK(scratch.empty());
+    }
+    SECTION("Inverted") {
+        const auto variant = sfdm::createImageVariant(image, sfdm::ImageVariant::Inverted, scratch);
+        CHECK(std::vector(variant.data, variant.data + 6) == std::vector<uint8_t>{255, 245, 235, 225, 215, 0});
+    }
+    SECTION("Mirrored") {
+        const auto variant = sfdm::createImageVariant(image, sfdm::ImageVariant::Mirrored, scratch);
+        CHECK(std::vector(variant.data, variant.data + 6) == std::vector<uint8_t>{20, 10, 0, 255, 40, 30});
+    }
+    SECTION("Inverted and mirrored") {
+        const auto variant = sfdm::createImageVariant(image, sfdm::ImageVariant::InvertedMirrored, scratch);
+        CHECK(std::vector(variant.data, variant.data + 6) == std::vector<uint8_t>{235, 245, 255, 0, 215, 225});
+    }
+    SECTION("Positions are mapped back") {
+        const sfdm::CodePosition position{{0, 1}, {0, 0}, {1, 0}, {1, 1}};
+        CHECK(sfdm::toOriginalPosition(position, sfdm::ImageVariant::Inverted, image) == position);
+        const auto mirrored = sfdm::toOriginalPosition(position, sfdm::ImageVariant::Mirrored, image);
+        CHECK(mirrored == sfdm::CodePosition{{2, 1}, {2, 0}, {1, 0}, {1, 1}});
+        CHECK(sfdm::toOriginalPosition(mirrored, sfdm::ImageVariant::Mirrored, image) == position);
+    }
+}
+
+TEST_CASE("Variant racing code reader") {
+    const auto annotated = getAnnotatedImage();
+    const auto view = toView(annotated.image);
+    const auto expected = sfdm::createCodeReader({sfdm::ReaderBackend::Libdmtx})->decode(view);
+    REQUIRE_FALSE(expected.empty());
+
+    SECTION("Inverted codes") {
+        std::vector<uint8_t> pixels;
+        const auto inverted = sfdm::createImageVariant(view, sfdm::ImageVariant::Inverted, pixels);
+        const auto reader = sfdm::createCodeReader({.backend = sfdm::ReaderBackend::Libdmtx, .tryInverted = true});
+        CHECK(sortedTexts(reader->decode(inverted)) == sortedTexts(expected));
+        // the normal image is still decoded
+        CHECK(sortedTexts(reader->decode(view)) == sortedTexts(expected));
+    }
+    SECTION("Mirrored codes") {
+        std::vector<uint8_t> pixels;
+        const auto mirrored = sfdm::createImageVariant(view, sfdm::ImageVariant::Mirrored, pixels);
+        const sfdm::VariantRacingCodeReader reader(sfdm::createCodeReader({sfdm::ReaderBackend::Libdmtx}),
+                                                   {sfdm::ImageVariant::Normal, sfdm::ImageVariant::Mirrored});
+        const auto results = reader.decode(mirrored);
+        REQUIRE(sortedTexts(results) == sortedTexts(expected));
+        // positions are reported in the mirrored image
+        for (const auto &result: results) {
+            const auto original = std::ranges::find(expected, result.text, &sfdm::DecodeResult::text);
+            const auto x = centerX(result.position);
+            const auto expectedX = static_cast<uint32_t>(view.width - 1 - centerX(original->position));
+            CHECK(std::max(x, expectedX) - std::min(x, expectedX) <= 5);
+        }
+    }
+    SECTION("Racing stops at the maximum number of codes") {
+        const sfdm::VariantRacingCodeReader reader(sfdm::createCodeReader({sfdm::ReaderBackend::Libdmtx}));
+        CHECK(reader.decode(view, {.maximumNumberOfCodesToDetect = 1}).size() == 1);
+    }
+    SECTION("Stop requested by the caller") {
+        const sfdm::VariantRacingCodeReader reader(sfdm::createCodeReader({sfdm::ReaderBackend::Libdmtx}));
+        std::stop_source stopSource;
+        stopSource.request_stop();
+        sfdm::DecodeOptions options;
+        options.stopToken = stopSource.get_token();
+        CHECK(reader.decode(view, options).empty());
+    }
+    SECTION("The location prior observes each frame once") {
+        std::vector<uint8_t> pixels;
+        const auto mirrored = sfdm::createImageVariant(view, sfdm::ImageVariant::Mirrored, pixels);
+        const sfdm::VariantRacingCodeReader reader(
+                sfdm::createCodeReader({sfdm::ReaderBackend::Libdmtx}),
+                {sfdm::ImageVariant::Normal, sfdm::ImageVariant::Inverted, sfdm::ImageVariant::Mirrored});
+        const auto prior = std::make_shared<sfdm::CodeLocationPrior>(8, 8, 0.5);
+        sfdm::DecodeOptions options;
+        options.locationPrior = prior;
+
+        const auto results = reader.decode(mirrored, options);
+        REQUIRE_FALSE(results.empty());
+        // one observation: no decay yet, one unit of heat per code
+        CHECK(totalHeat(*prior) == static_cast<double>(results.size()));
+        // the heat lies where the codes are in the decoded image
+        for (const auto &result: results) {
+            CHECK(prior->getHeat(centerX(result.position) * 8 / mirrored.width,
+                                 centerY(result.position) * 8 / mirrored.height) >= 1.0);
+        }
+
+        const auto nextResults = reader.decode(mirrored, options);
+        CHECK(totalHeat(*prior) == 0.5 * static_cast<double>(results.size()) + static_cast<double>(nextResults.size()));
+    }
+    SECTION("Lazy decode in the variant of the detection") {
+        std::vector<uint8_t> pixels;
+        const auto inverted = sfdm::createImageVariant(view, sfdm::ImageVariant::Inverted, pixels);
+        const sfdm::VariantRacingCodeReader reader(sfdm::createCodeReader({sfdm::ReaderBackend::Libdmtx}));
+        const auto detections = reader.detect(inverted);
+        REQUIRE_FALSE(detections.empty());
+        const auto result = reader.decode(inverted, detections.front());
+        REQUIRE(result.has_value());
+        CHECK(std::ranges::find(expected, result->text, &sfdm::DecodeResult::text) != expected.end());
+    }
+}
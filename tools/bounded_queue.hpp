@@ -0,0 +1,70 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace sfdm::tools {
+    /*!
+     * Blocking multi producer multi consumer queue with a fixed capacity. The storage is allocated once, so pushing
+     * and popping does not allocate.
+     */
+    template<typename T>
+    class BoundedQueue {
+    public:
+        explicit BoundedQueue(size_t capacity) : m_items(capacity) {}
+
+        /*!
+         * Blocks while the queue is full.
+         * @return false, if the queue was closed
+         */
+        bool push(T item) {
+            std::unique_lock lock(m_mutex);
+            m_notFull.wait(lock, [&] { return m_closed || m_size < m_items.size(); });
+            if (m_closed) {
+                return false;
+            }
+            m_items[(m_head + m_size) % m_items.size()] = std::move(item);
+            ++m_size;
+            m_notEmpty.notify_one();
+            return true;
+        }
+
+        /*!
+         * Blocks while the queue is empty.
+         * @return Next item, or nothing if the queue was closed and is drained
+         */
+        std::optional<T> pop() {
+            std::unique_lock lock(m_mutex);
+            m_notEmpty.wait(lock, [&] { return m_closed || m_size > 0; });
+            if (m_size == 0) {
+                return std::nullopt;
+            }
+            std::optional<T> item{std::move(m_items[m_head])};
+            m_head = (m_head + 1) % m_items.size();
+            --m_size;
+            m_notFull.notify_one();
+            return item;
+        }
+
+        /*!
+         * Wakes up all waiting threads. Remaining items can still be popped.
+         */
+        void close() {
+            std::lock_guard lock(m_mutex);
+            m_closed = true;
+            m_notFull.notify_all();
+            m_notEmpty.notify_all();
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_notFull;
+        std::condition_variable m_notEmpty;
+        std::vector<T> m_items;
+        size_t m_head{};
+        size_t m_size{};
+        bool m_closed{};
+    };
+} // namespace sfdm::tools
@@ -0,0 +1,91 @@
+#include "dataset.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <opencv2/opencv.hpp>
+#include <sstream>
+
+namespace {
+    bool isImageFile(const std::filesystem::path &path) {
+        constexpr std::array extensions{".jpg", ".jpeg", ".png", ".bmp", ".pgm", ".tif", ".tiff"};
+        const auto extension = path.extension().string();
+        return std::ranges::find(extensions, extension) != extensions.end();
+    }
+} // namespace
+
+namespace sfdm::tools {
+    Annotations readAnnotations(const std::filesystem::path &file) {
+        Annotations result;
+        std::ifstream stream(file);
+        if (!stream.is_open()) {
+            return result;
+        }
+
+        std::string line;
+        while (std::getline(stream, line)) {
+            std::erase(line, '\r');
+            const auto pos = line.find('=');
+            if (pos == std::string::npos) {
+                continue;
+            }
+
+            const std::string key = line.substr(0, pos);
+            std::stringstream ss(line.substr(pos + 1));
+            std::string token;
+            while (std::getline(ss, token, '|')) {
+                if (!token.empty()) {
+                    std::erase(token, '"');
+                    result[key].emplace_back(token);
+                }
+            }
+        }
+        return result;
+    }
+
+    std::string normalizeText(std::string text) {
+        std::erase(text, '\r');
+        std::ranges::replace(text, '\n', ' ');
+        return text;
+    }
+
+    size_t countMatches(std::vector<std::string> found, const std::vector<std::string> &expected) {
+        size_t matches = 0;
+        for (const auto &text: expected) {
+            const auto it = std::ranges::find(found, text);
+            if (it != found.end()) {
+                found.erase(it);
+                ++matches;
+            }
+        }
+        return matches;
+    }
+
+    std::vector<LabeledImage> loadLabeledImages(const std::filesystem::path &folder, const Annotations &annotations) {
+        std::vector<LabeledImage> result;
+        for (const auto &entry: std::filesystem::directory_iterator(folder)) {
+            if (!entry.is_regular_file() || !isImageFile(entry.path())) {
+                continue;
+            }
+            const auto name = entry.path().stem().string();
+            const auto it = annotations.find(name);
+            if (it == annotations.end()) {
+                continue;
+            }
+
+            const cv::Mat image = cv::imread(entry.path().string(), cv::IMREAD_GRAYSCALE);
+            if (image.empty()) {
+                continue;
+            }
+
+            GrayImage grayImage{static_cast<size_t>(image.cols), static_cast<size_t>(image.rows), {}};
+            grayImage.pixels.resize(grayImage.width * grayImage.height);
+            for (int row = 0; row < image.rows; ++row) {
+                std::copy_n(image.ptr<uint8_t>(row), image.cols, grayImage.pixels.data() + row * image.cols);
+            }
+            result.emplace_back(name, std::move(grayImage), it->second);
+        }
+        std::ranges::sort(result, {}, &LabeledImage::name);
+        return result;
+    }
+} // namespace sfdm::tools
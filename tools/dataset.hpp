@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <sfdm/image_view.hpp>
+#include <string>
+#include <vector>
+
+namespace sfdm::tools {
+    using Annotations = std::map<std::string, std::vector<std::string>>;
+
+    struct GrayImage {
+        size_t width{};
+        size_t height{};
+        std::vector<uint8_t> pixels;
+
+        [[nodiscard]] ImageView view() { return {width, height, pixels.data()}; }
+    };
+
+    struct LabeledImage {
+        std::string name;
+        GrayImage image;
+        std::vector<std::string> expectedTexts;
+    };
+
+    /*!
+     * Reads an annotation file with lines of the form: name="text1"|"text2"
+     */
+    [[nodiscard]] Annotations readAnnotations(const std::filesystem::path &file);
+
+    /*!
+     * Some codes contain newlines, but annotations do not.
+     */
+    [[nodiscard]] std::string normalizeText(std::string text);
+
+    /*!
+     * Number of expected texts that are contained in found. Every found text can only match once.
+     */
+    [[nodiscard]] size_t countMatches(std::vector<std::string> found, const std::vector<std::string> &expected);
+
+    /*!
+     * Loads all images of the folder, that have an entry in the annotations, as 8 bit grayscale images.
+     */
+    [[nodiscard]] std::vector<LabeledImage> loadLabeledImages(const std::filesystem::path &folder,
+                                                              const Annotations &annotations);
+} // namespace sfdm::tools
@@ -0,0 +1,144 @@
+#include "mapped_image.hpp"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace {
+    class PgmHeaderParser {
+    public:
+        PgmHeaderParser(const uint8_t *data, size_t size) : m_data{data}, m_size{size} {}
+
+        size_t parseNumber() {
+            skipWhitespaceAndComments();
+            if (m_pos >= m_size || !std::isdigit(m_data[m_pos])) {
+                throw std::runtime_error{"Invalid PGM header!"};
+            }
+            // bounded while parsing, so a corrupt header cannot wrap the value
+            size_t value = 0;
+            while (m_pos < m_size && std::isdigit(m_data[m_pos])) {
+                value = value * 10 + static_cast<size_t>(m_data[m_pos++] - '0');
+                if (value > std::numeric_limits<uint32_t>::max()) {
+                    throw std::runtime_error{"Invalid PGM header!"};
+                }
+            }
+            return value;
+        }
+
+        void expectMagic() {
+            if (m_size < 2 || m_data[0] != 'P' || m_data[1] != '5') {
+                throw std::runtime_error{"Only binary PGM (P5) images are supported!"};
+            }
+            m_pos = 2;
+        }
+
+        // exactly one whitespace character separates the header from the pixels
+        size_t pixelOffset() const { return m_pos + 1; }
+
+    private:
+        void skipWhitespaceAndComments() {
+            while (m_pos < m_size) {
+                if (m_data[m_pos] == '#') {
+                    while (m_pos < m_size && m_data[m_pos] != '\n') {
+                        ++m_pos;
+                    }
+                } else if (std::isspace(m_data[m_pos])) {
+                    ++m_pos;
+                } else {
+                    return;
+                }
+            }
+        }
+
+        const uint8_t *m_data;
+        size_t m_size;
+        size_t m_pos{};
+    };
+} // namespace
+
+namespace sfdm::tools {
+    MappedImage::~MappedImage() { reset(); }
+
+    MappedImage::MappedImage(MappedImage &&other) noexcept :
+        m_address{std::exchange(other.m_address, nullptr)}, m_size{std::exchange(other.m_size, 0)},
+        m_view{std::exchange(other.m_view, {})} {}
+
+    MappedImage &MappedImage::operator=(MappedImage &&other) noexcept {
+        if (this != &other) {
+            reset();
+            m_address = std::exchange(other.m_address, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_view = std::exchange(other.m_view, {});
+        }
+        return *this;
+    }
+
+    void MappedImage::reset() {
+        if (m_address) {
+            munmap(m_address, m_size);
+        }
+        m_address = nullptr;
+        m_size = 0;
+        m_view = {};
+    }
+
+    MappedImage MappedImage::open(const std::filesystem::path &path, std::optional<RawImageSize> rawSize,
+                                  bool prefetch) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error{"Could not open " + path.string() + ": " + std::strerror(errno)};
+        }
+        struct stat info {};
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            close(fd);
+            throw std::runtime_error{"Could not read " + path.string()};
+        }
+
+        MappedImage image;
+        image.m_size = static_cast<size_t>(info.st_size);
+        // private writable mapping: ImageView needs a mutable pointer, the readers never write, so pages stay shared
+        image.m_address = mmap(nullptr, image.m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (image.m_address == MAP_FAILED) {
+            image.m_address = nullptr;
+            throw std::runtime_error{"Could not map " + path.string() + ": " + std::strerror(errno)};
+        }
+        if (prefetch) {
+            madvise(image.m_address, image.m_size, MADV_WILLNEED);
+        }
+
+        auto *data = static_cast<uint8_t *>(image.m_address);
+        if (path.extension() == ".pgm") {
+            PgmHeaderParser parser(data, image.m_size);
+            parser.expectMagic();
+            const auto width = parser.parseNumber();
+            const auto height = parser.parseNumber();
+            const auto maxValue = parser.parseNumber();
+            if (maxValue == 0 || maxValue > 255) {
+                throw std::runtime_error{"Only 8 bit PGM images are supported: " + path.string()};
+            }
+            image.m_view = {width, height, data + parser.pixelOffset()};
+        } else {
+            if (!rawSize) {
+                throw std::runtime_error{"Size of raw image is unknown: " + path.string()};
+            }
+            image.m_view = {rawSize->width, rawSize->height, data};
+        }
+
+        // divided instead of multiplied, width * height may not fit into size_t
+        const auto offset = static_cast<size_t>(image.m_view.data - data);
+        if (image.m_view.width == 0 || image.m_view.height == 0 || offset > image.m_size ||
+            image.m_view.width > (image.m_size - offset) / image.m_view.height) {
+            throw std::runtime_error{"Image file is truncated: " + path.string()};
+        }
+        return image;
+    }
+} // namespace sfdm::tools
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <sfdm/image_view.hpp>
+
+namespace sfdm::tools {
+    struct RawImageSize {
+        size_t width{};
+        size_t height{};
+    };
+
+    /*!
+     * Memory mapped 8 bit grayscale image. The ImageView points directly into the mapped pages of the file, nothing
+     * is copied. Supports binary PGM (P5) and headerless raw files, which need their size to be known.
+     * POSIX only.
+     */
+    class MappedImage {
+    public:
+        MappedImage() = default;
+        ~MappedImage();
+        MappedImage(MappedImage &&other) noexcept;
+        MappedImage &operator=(MappedImage &&other) noexcept;
+        MappedImage(const MappedImage &) = delete;
+        MappedImage &operator=(const MappedImage &) = delete;
+
+        /*!
+         * Maps the file. Files with the extension .pgm are parsed as PGM, everything else is treated as raw image.
+         * Throws on errors.
+         * @param path file to map
+         * @param rawSize size of raw images
+         * @param prefetch asks the kernel to read the whole file ahead
+         */
+        static MappedImage open(const std::filesystem::path &path, std::optional<RawImageSize> rawSize,
+                                bool prefetch = true);
+
+        [[nodiscard]] const ImageView &view() const { return m_view; }
+
+    private:
+        void reset();
+
+        void *m_address{};
+        size_t m_size{};
+        ImageView m_view{};
+    };
+} // namespace sfdm::tools
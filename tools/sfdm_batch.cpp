@@ -0,0 +1,426 @@
+#include <sfdm/decode_result_buffer.hpp>
+#include <sfdm/reader_config.hpp>
+
+#include "bounded_queue.hpp"
+#include "mapped_image.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Decodes large amounts of PGM/raw images. Loading, decoding and writing the results run as separate pipeline stages.
+// usage: sfdm_batch <file or folder>... [--list <file>] [--config <reader config>] [--codes <n>]
+//                   [--format jsonl|csv] [--output <file>] [--workers <n>] [--loaders <n>] [--queue-depth <n>]
+//                   [--raw-size <width>x<height>]
+
+namespace {
+    enum class OutputFormat {
+        JsonLines,
+        Csv,
+    };
+
+    struct Arguments {
+        std::vector<std::filesystem::path> inputs;
+        sfdm::ReaderConfig readerConfig;
+        size_t maximumNumberOfCodes{255};
+        OutputFormat format{OutputFormat::JsonLines};
+        std::filesystem::path outputFile;
+        size_t workerCount{std::max(1U, std::thread::hardware_concurrency())};
+        size_t loaderCount{2};
+        size_t queueDepth{0};
+        std::optional<sfdm::tools::RawImageSize> rawSize;
+    };
+
+    struct LoadedImage {
+        size_t index{};
+        sfdm::tools::MappedImage image;
+        std::string error;
+    };
+
+    // recycled between the decode and the emit stage, so the result storage is allocated once per slot
+    struct DecodedImage {
+        size_t index{};
+        sfdm::DecodeResultBuffer results;
+        double milliseconds{};
+        std::string error;
+    };
+
+    void printUsage() {
+        std::cerr << "usage: sfdm_batch <file or folder>... [--list <file>] [--config <reader config>] [--codes <n>] "
+                     "[--format jsonl|csv] [--output <file>] [--workers <n>] [--loaders <n>] [--queue-depth <n>] "
+                     "[--raw-size <width>x<height>]\n";
+    }
+
+    bool isImageFile(const std::filesystem::path &path) {
+        return path.extension() == ".pgm" || path.extension() == ".raw";
+    }
+
+    void addInput(std::vector<std::filesystem::path> &inputs, const std::filesystem::path &path) {
+        if (!std::filesystem::is_directory(path)) {
+            inputs.emplace_back(path);
+            return;
+        }
+        for (const auto &entry: std::filesystem::recursive_directory_iterator(path)) {
+            if (entry.is_regular_file() && isImageFile(entry.path())) {
+                inputs.emplace_back(entry.path());
+            }
+        }
+    }
+
+    Arguments parseArguments(int argc, char **argv) {
+        Arguments arguments;
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            if (!argument.starts_with("--")) {
+                addInput(arguments.inputs, argument);
+                continue;
+            }
+            if (i + 1 >= argc) {
+                throw std::runtime_error{"missing value for " + argument};
+            }
+            const std::string value = argv[++i];
+            if (argument == "--list") {
+                std::ifstream list(value);
+                if (!list.is_open()) {
+                    throw std::runtime_error{"could not open " + value};
+                }
+                std::string line;
+                while (std::getline(list, line)) {
+                    if (!line.empty()) {
+                        arguments.inputs.emplace_back(line);
+                    }
+                }
+            } else if (argument == "--config") {
+                arguments.readerConfig = sfdm::loadReaderConfig(value);
+            } else if (argument == "--codes") {
+                arguments.maximumNumberOfCodes = std::stoul(value);
+            } else if (argument == "--format") {
+                if (value == "jsonl") {
+                    arguments.format = OutputFormat::JsonLines;
+                } else if (value == "csv") {
+                    arguments.format = OutputFormat::Csv;
+                } else {
+                    throw std::runtime_error{"unknown format " + value};
+                }
+            } else if (argument == "--output") {
+                arguments.outputFile = value;
+            } else if (argument == "--workers") {
+                arguments.workerCount = std::max<size_t>(1, std::stoul(value));
+            } else if (argument == "--loaders") {
+                arguments.loaderCount = std::max<size_t>(1, std::stoul(value));
+            } else if (argument == "--queue-depth") {
+                arguments.queueDepth = std::stoul(value);
+            } else if (argument == "--raw-size") {
+                const auto separator = value.find('x');
+                if (separator == std::string::npos) {
+                    throw std::runtime_error{"raw size has to be <width>x<height>"};
+                }
+                arguments.rawSize = {std::stoul(value.substr(0, separator)), std::stoul(value.substr(separator + 1))};
+            } else {
+                throw std::runtime_error{"unknown argument " + argument};
+            }
+        }
+        if (arguments.inputs.empty()) {
+            throw std::runtime_error{"no input images"};
+        }
+        if (arguments.queueDepth == 0) {
+            arguments.queueDepth = 2 * arguments.workerCount;
+        }
+        return arguments;
+    }
+
+    // length of the valid UTF-8 sequence starting at value[i], 0 if the byte does not start one
+    size_t utf8SequenceLength(std::string_view value, size_t i) {
+        const auto lead = static_cast<unsigned char>(value[i]);
+        size_t length = 0;
+        unsigned char min = 0x80;
+        unsigned char max = 0xbf;
+        if (lead >= 0xc2 && lead <= 0xdf) {
+            length = 2;
+        } else if (lead >= 0xe0 && lead <= 0xef) {
+            length = 3;
+            // overlong encodings and surrogates
+            min = lead == 0xe0 ? 0xa0 : 0x80;
+            max = lead == 0xed ? 0x9f : 0xbf;
+        } else if (lead >= 0xf0 && lead <= 0xf4) {
+            length = 4;
+            min = lead == 0xf0 ? 0x90 : 0x80;
+            max = lead == 0xf4 ? 0x8f : 0xbf;
+        } else {
+            return 0;
+        }
+        if (i + length > value.size()) {
+            return 0;
+        }
+        for (size_t k = 1; k < length; ++k) {
+            const auto byte = static_cast<unsigned char>(value[i + k]);
+            if (byte < (k == 1 ? min : 0x80) || byte > (k == 1 ? max : 0xbf)) {
+                return 0;
+            }
+        }
+        return length;
+    }
+
+    void appendUnicodeEscape(std::string &out, unsigned char c) {
+        char escaped[7];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        out += escaped;
+    }
+
+    // libdmtx returns the raw payload bytes, e.g. Latin-1. Bytes, that are not valid UTF-8, are read as Latin-1 and
+    // escaped, so every line stays valid JSON.
+    void appendJsonString(std::string &out, std::string_view value) {
+        out += '"';
+        for (size_t i = 0; i < value.size(); ++i) {
+            const char c = value[i];
+            if (static_cast<unsigned char>(c) >= 0x80) {
+                const auto length = utf8SequenceLength(value, i);
+                if (length == 0) {
+                    appendUnicodeEscape(out, static_cast<unsigned char>(c));
+                } else {
+                    out += value.substr(i, length);
+                    i += length - 1;
+                }
+                continue;
+            }
+            switch (c) {
+                case '"':
+                    out += "\\\"";
+                    break;
+                case '\\':
+                    out += "\\\\";
+                    break;
+                case '\n':
+                    out += "\\n";
+                    break;
+                case '\r':
+                    out += "\\r";
+                    break;
+                case '\t':
+                    out += "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        appendUnicodeEscape(out, static_cast<unsigned char>(c));
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        out += '"';
+    }
+
+    void appendCsvField(std::string &out, std::string_view value) {
+        out += '"';
+        for (const char c: value) {
+            if (c == '"') {
+                out += '"';
+            }
+            out += c;
+        }
+        out += '"';
+    }
+
+    void appendPoint(std::string &out, const sfdm::Point &point, char separator) {
+        out += std::to_string(point.x);
+        out += separator;
+        out += std::to_string(point.y);
+    }
+
+    // the line buffer is reused for every image, so formatting does not allocate in the steady state
+    void formatJson(std::string &line, const std::filesystem::path &path, const DecodedImage &decoded) {
+        line += "{\"file\":";
+        appendJsonString(line, path.native());
+        line += ",\"decode_ms\":";
+        line += std::to_string(decoded.milliseconds);
+        if (!decoded.error.empty()) {
+            line += ",\"error\":";
+            appendJsonString(line, decoded.error);
+        }
+        line += ",\"codes\":[";
+        for (size_t i = 0; i < decoded.results.size(); ++i) {
+            const auto result = decoded.results[i];
+            line += i == 0 ? "{\"text\":" : ",{\"text\":";
+            appendJsonString(line, result.text);
+            line += ",\"position\":[";
+            for (const auto &point: {result.position.bottomLeft, result.position.topLeft, result.position.topRight,
+                                     result.position.bottomRight}) {
+                line += '[';
+                appendPoint(line, point, ',');
+                line += "],";
+            }
+            line.back() = ']';
+            line += '}';
+        }
+        line += "]}\n";
+    }
+
+    void formatCsvRow(std::string &line, const std::filesystem::path &path, const DecodedImage &decoded,
+                      const sfdm::DecodeResultView *result) {
+        appendCsvField(line, path.native());
+        line += ',';
+        line += std::to_string(decoded.results.size());
+        line += ',';
+        line += std::to_string(decoded.milliseconds);
+        line += ',';
+        if (result) {
+            appendCsvField(line, result->text);
+            for (const auto &point: {result->position.bottomLeft, result->position.topLeft, result->position.topRight,
+                                     result->position.bottomRight}) {
+                line += ',';
+                appendPoint(line, point, ',');
+            }
+        } else {
+            line += ",,,,,,,,";
+        }
+        line += ',';
+        appendCsvField(line, decoded.error);
+        line += '\n';
+    }
+
+    void formatCsv(std::string &line, const std::filesystem::path &path, const DecodedImage &decoded) {
+        if (decoded.results.empty()) {
+            formatCsvRow(line, path, decoded, nullptr);
+        }
+        for (size_t i = 0; i < decoded.results.size(); ++i) {
+            const auto result = decoded.results[i];
+            formatCsvRow(line, path, decoded, &result);
+        }
+    }
+
+    void load(const Arguments &arguments, std::atomic<size_t> &nextIndex,
+              sfdm::tools::BoundedQueue<LoadedImage> &loadQueue) {
+        for (size_t index = nextIndex++; index < arguments.inputs.size(); index = nextIndex++) {
+            LoadedImage loaded{index, {}, {}};
+            try {
+                loaded.image = sfdm::tools::MappedImage::open(arguments.inputs[index], arguments.rawSize);
+            } catch (const std::exception &e) {
+                loaded.error = e.what();
+            }
+            if (!loadQueue.push(std::move(loaded))) {
+                return;
+            }
+        }
+    }
+
+    void decode(const sfdm::ICodeReader &reader, const sfdm::DecodeOptions &options,
+                sfdm::tools::BoundedQueue<LoadedImage> &loadQueue, sfdm::tools::BoundedQueue<DecodedImage> &emitQueue,
+                sfdm::tools::BoundedQueue<DecodedImage> &recycleQueue) {
+        while (auto loaded = loadQueue.pop()) {
+            auto decoded = recycleQueue.pop();
+            if (!decoded) {
+                return;
+            }
+            decoded->index = loaded->index;
+            decoded->results.clear();
+            decoded->milliseconds = 0.0;
+            decoded->error.clear();
+            if (!loaded->error.empty()) {
+                decoded->error = loaded->error;
+            } else {
+                try {
+                    const auto start = std::chrono::steady_clock::now();
+                    reader.decode(loaded->image.view(), options, decoded->results);
+                    decoded->milliseconds =
+                            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                                    .count();
+                } catch (const std::exception &e) {
+                    decoded->results.clear();
+                    decoded->error = e.what();
+                }
+            }
+            // unmap as early as possible, the pipeline only keeps queueDepth images mapped
+            loaded->image = {};
+            emitQueue.push(std::move(*decoded));
+        }
+    }
+
+    void emit(const Arguments &arguments, sfdm::tools::BoundedQueue<DecodedImage> &emitQueue,
+              sfdm::tools::BoundedQueue<DecodedImage> &recycleQueue, std::ostream &out) {
+        std::string line;
+        line.reserve(4096);
+        if (arguments.format == OutputFormat::Csv) {
+            out << "file,code_count,decode_ms,text,bottom_left_x,bottom_left_y,top_left_x,top_left_y,top_right_x,"
+                   "top_right_y,bottom_right_x,bottom_right_y,error\n";
+        }
+        size_t failed = 0;
+        while (auto decoded = emitQueue.pop()) {
+            line.clear();
+            const auto &path = arguments.inputs[decoded->index];
+            if (arguments.format == OutputFormat::JsonLines) {
+                formatJson(line, path, *decoded);
+            } else {
+                formatCsv(line, path, *decoded);
+            }
+            out.write(line.data(), static_cast<std::streamsize>(line.size()));
+            if (!decoded->error.empty()) {
+                ++failed;
+            }
+            // the recycle queue holds every slot, so this never blocks
+            recycleQueue.push(std::move(*decoded));
+        }
+        out.flush();
+        if (failed) {
+            std::cerr << failed << " of " << arguments.inputs.size() << " images could not be decoded\n";
+        }
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    try {
+        const auto arguments = parseArguments(argc, argv);
+
+        std::ofstream outputFile;
+        if (!arguments.outputFile.empty()) {
+            outputFile.open(arguments.outputFile, std::ios::binary);
+            if (!outputFile.is_open()) {
+                throw std::runtime_error{"could not open " + arguments.outputFile.string()};
+            }
+        }
+        std::ostream &out = arguments.outputFile.empty() ? std::cout : outputFile;
+
+        sfdm::tools::BoundedQueue<LoadedImage> loadQueue(arguments.queueDepth);
+        sfdm::tools::BoundedQueue<DecodedImage> emitQueue(arguments.queueDepth);
+        // slots queued for emitting, one per decoder and one formatted by the emitter
+        const auto slotCount = arguments.queueDepth + arguments.workerCount + 1;
+        sfdm::tools::BoundedQueue<DecodedImage> recycleQueue(slotCount);
+        for (size_t i = 0; i < slotCount; ++i) {
+            recycleQueue.push(DecodedImage());
+        }
+        std::atomic<size_t> nextIndex = 0;
+
+        // readers are stateless while decoding, so all decoders share one
+        const auto reader = sfdm::createCodeReader(arguments.readerConfig);
+        auto options = reader->getDefaultOptions();
+        options.maximumNumberOfCodesToDetect = arguments.maximumNumberOfCodes;
+
+        std::jthread emitter([&] { emit(arguments, emitQueue, recycleQueue, out); });
+        {
+            std::vector<std::jthread> decoders;
+            decoders.reserve(arguments.workerCount);
+            for (size_t i = 0; i < arguments.workerCount; ++i) {
+                decoders.emplace_back([&] { decode(*reader, options, loadQueue, emitQueue, recycleQueue); });
+            }
+            {
+                std::vector<std::jthread> loaders;
+                loaders.reserve(arguments.loaderCount);
+                for (size_t i = 0; i < arguments.loaderCount; ++i) {
+                    loaders.emplace_back([&] { load(arguments, nextIndex, loadQueue); });
+                }
+            }
+            loadQueue.close();
+        }
+        emitQueue.close();
+    } catch (const std::exception &e) {
+        std::cerr << "error: " << e.what() << '\n';
+        printUsage();
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <sfdm/reader_config.hpp>
+#include <sfdm/shm_decode_service.hpp>
+
+#include <csignal>
+#include <iostream>
+#include <pthread.h>
+#include <stdexcept>
+
+// Decodes frames from a shared memory ring until SIGINT or SIGTERM.
+// usage: sfdm_decode_server <shm name> [--config <reader config>] [--slots <n>] [--max-frame-bytes <n>]
+//                           [--max-results <n>] [--workers <n>]
+
+namespace {
+    void printUsage() {
+        std::cerr << "usage: sfdm_decode_server <shm name> [--config <reader config>] [--slots <n>] "
+                     "[--max-frame-bytes <n>] [--max-results <n>] [--workers <n>]\n";
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    try {
+        if (argc < 2) {
+            throw std::runtime_error{"missing shared memory name"};
+        }
+        sfdm::shm::ShmDecodeServerConfig serverConfig{argv[1]};
+        sfdm::ReaderConfig readerConfig;
+        for (int i = 2; i < argc; ++i) {
+            const std::string argument = argv[i];
+            if (i + 1 >= argc) {
+                throw std::runtime_error{"missing value for " + argument};
+            }
+            const std::string value = argv[++i];
+            if (argument == "--config") {
+                readerConfig = sfdm::loadReaderConfig(value);
+            } else if (argument == "--slots") {
+                serverConfig.slotCount = static_cast<uint32_t>(std::stoul(value));
+            } else if (argument == "--max-frame-bytes") {
+                serverConfig.maxFrameBytes = std::stoull(value);
+            } else if (argument == "--max-results") {
+                serverConfig.maxResultsPerFrame = static_cast<uint32_t>(std::stoul(value));
+            } else if (argument == "--workers") {
+                serverConfig.workerCount = std::stoul(value);
+            } else {
+                throw std::runtime_error{"unknown argument " + argument};
+            }
+        }
+
+        // blocked before the workers start, so they inherit the mask and only sigwait receives the signals. Nothing
+        // runs in a signal handler.
+        sigset_t stopSignals;
+        sigemptyset(&stopSignals);
+        sigaddset(&stopSignals, SIGINT);
+        sigaddset(&stopSignals, SIGTERM);
+        if (pthread_sigmask(SIG_BLOCK, &stopSignals, nullptr) != 0) {
+            throw std::runtime_error{"could not block the stop signals"};
+        }
+
+        sfdm::shm::ShmDecodeServer server(serverConfig, [&] { return sfdm::createCodeReader(readerConfig); });
+        std::cerr << "decoding frames from " << serverConfig.name << " with " << serverConfig.workerCount
+                  << " workers (" << sfdm::toString(readerConfig.backend) << ")\n";
+        int signal = 0;
+        sigwait(&stopSignals, &signal);
+        server.stop();
+    } catch (const std::exception &e) {
+        std::cerr << "error: " << e.what() << '\n';
+        printUsage();
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <sfdm/reader_config.hpp>
+
+#include "mapped_image.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+// Re-runs frames captured by the RecordingCodeReader and reports the decode times.
+// usage: sfdm_replay <capture folder or .txt file>... [--config <reader config>] [--repeat <n>]
+
+namespace {
+    struct Arguments {
+        std::vector<std::filesystem::path> captures;
+        std::optional<sfdm::ReaderConfig> readerConfig;
+        size_t repeat{5};
+    };
+
+    struct CaptureInfo {
+        sfdm::DecodeOptions options;
+        std::optional<int64_t> deadlineMSec;
+        double recordedMilliseconds{};
+        size_t recordedCodeCount{};
+    };
+
+    void printUsage() {
+        std::cerr << "usage: sfdm_replay <capture folder or .txt file>... [--config <reader config>] [--repeat <n>]\n";
+    }
+
+    void addCaptures(std::vector<std::filesystem::path> &captures, const std::filesystem::path &path) {
+        if (!std::filesystem::is_directory(path)) {
+            captures.emplace_back(path);
+            return;
+        }
+        std::vector<std::filesystem::path> found;
+        for (const auto &entry: std::filesystem::directory_iterator(path)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+                found.emplace_back(entry.path());
+            }
+        }
+        std::ranges::sort(found);
+        captures.insert(captures.end(), found.begin(), found.end());
+    }
+
+    Arguments parseArguments(int argc, char **argv) {
+        Arguments arguments;
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            if (!argument.starts_with("--")) {
+                addCaptures(arguments.captures, argument);
+                continue;
+            }
+            if (i + 1 >= argc) {
+                throw std::runtime_error{"missing value for " + argument};
+            }
+            const std::string value = argv[++i];
+            if (argument == "--config") {
+                arguments.readerConfig = sfdm::loadReaderConfig(value);
+            } else if (argument == "--repeat") {
+                arguments.repeat = std::max<size_t>(1, std::stoul(value));
+            } else {
+                throw std::runtime_error{"unknown argument " + argument};
+            }
+        }
+        if (arguments.captures.empty()) {
+            throw std::runtime_error{"no captures"};
+        }
+        return arguments;
+    }
+
+    // only the keys needed for the replay are read, the result lines are for humans. Expected payloads and the
+    // location prior of the recorded call are not part of the capture.
+    CaptureInfo readCaptureInfo(const std::filesystem::path &path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            throw std::runtime_error{"could not open " + path.string()};
+        }
+        CaptureInfo info;
+        std::string line;
+        while (std::getline(file, line)) {
+            const auto separator = line.find('=');
+            if (separator == std::string::npos) {
+                continue;
+            }
+            const auto key = line.substr(0, separator);
+            const auto value = line.substr(separator + 1);
+            if (sfdm::readDecodeOption(info.options, key, value)) {
+                continue;
+            }
+            if (key == "deadline_ms") {
+                info.deadlineMSec = std::stoll(value);
+            } else if (key == "decode_ms") {
+                info.recordedMilliseconds = std::stod(value);
+            } else if (key == "result_count") {
+                info.recordedCodeCount = std::stoul(value);
+            }
+        }
+        return info;
+    }
+
+    void replay(const Arguments &arguments, const std::filesystem::path &capturePath) {
+        const auto info = readCaptureInfo(capturePath);
+        auto basePath = capturePath;
+        basePath.replace_extension();
+        const auto image = sfdm::tools::MappedImage::open(basePath.string() + ".pgm", std::nullopt);
+
+        auto readerConfig = arguments.readerConfig;
+        const std::filesystem::path configPath = basePath.string() + ".cfg";
+        if (!readerConfig && std::filesystem::exists(configPath)) {
+            readerConfig = sfdm::loadReaderConfig(configPath);
+        }
+        const auto reader = sfdm::createCodeReader(readerConfig.value_or(sfdm::ReaderConfig{}));
+        auto options = info.options;
+
+        std::vector<double> milliseconds;
+        milliseconds.reserve(arguments.repeat);
+        size_t codeCount = 0;
+        for (size_t i = 0; i < arguments.repeat; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            // the deadline is recreated relative to the start of each run, as the recorded call saw it
+            if (info.deadlineMSec) {
+                options.deadline = start + std::chrono::milliseconds{*info.deadlineMSec};
+            }
+            codeCount = reader->decode(image.view(), options).size();
+            milliseconds.push_back(
+                    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::ranges::sort(milliseconds);
+        double sum = 0;
+        for (const auto value: milliseconds) {
+            sum += value;
+        }
+
+        char line[512];
+        std::snprintf(line, sizeof(line), "%-40s %10.2f %10.2f %10.2f %10.2f %5zu %5zu %5zu\n",
+                      capturePath.filename().string().c_str(), info.recordedMilliseconds, milliseconds.front(),
+                      sum / static_cast<double>(milliseconds.size()), milliseconds.back(),
+                      info.options.maximumNumberOfCodesToDetect,
+                      info.recordedCodeCount, codeCount);
+        std::cout << line;
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    try {
+        const auto arguments = parseArguments(argc, argv);
+        std::cout << "capture                                  recorded_ms     min_ms    mean_ms     max_ms codes "
+                     "  rec found\n";
+        for (const auto &capture: arguments.captures) {
+            try {
+                replay(arguments, capture);
+            } catch (const std::exception &e) {
+                std::cerr << capture.string() << ": " << e.what() << '\n';
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "error: " << e.what() << '\n';
+        printUsage();
+        return 1;
+    }
+    return 0;
+}
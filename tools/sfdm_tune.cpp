@@ -0,0 +1,244 @@
+#include <sfdm/reader_config.hpp>
+
+#include "dataset.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Sweeps all reader configurations over a labeled dataset and prints the latency-vs-recall pareto frontier.
+// usage: sfdm_tune <image folder> [--annotations <file>] [--output <config file>] [--threads <n>]
+//                  [--timeouts <ms,ms,...>] [--min-recall <0..1>]
+
+namespace {
+    struct Arguments {
+        std::filesystem::path imageFolder;
+        std::filesystem::path annotationsFile;
+        std::filesystem::path outputFile{"sfdm_reader.cfg"};
+        // concurrent decodes compete for cores and memory bandwidth, which inflates the latencies and, with
+        // timeouts, lowers the recall, so the timed sweep runs serially unless asked otherwise
+        size_t threadCount{1};
+        std::vector<uint32_t> timeouts{0, 50, 100, 200};
+        double minRecall{-1.0};
+    };
+
+    struct Measurement {
+        double milliseconds{};
+        size_t found{};
+    };
+
+    struct Evaluation {
+        sfdm::ReaderConfig config;
+        double meanMilliseconds{};
+        double maxMilliseconds{};
+        double recall{};
+        bool paretoOptimal{};
+    };
+
+    void printUsage() {
+        std::cerr << "usage: sfdm_tune <image folder> [--annotations <file>] [--output <config file>] "
+                     "[--threads <n>] [--timeouts <ms,ms,...>] [--min-recall <0..1>]\n";
+    }
+
+    std::vector<uint32_t> parseTimeouts(const std::string &value) {
+        std::vector<uint32_t> timeouts;
+        std::stringstream ss(value);
+        std::string token;
+        while (std::getline(ss, token, ',')) {
+            timeouts.emplace_back(static_cast<uint32_t>(std::stoul(token)));
+        }
+        return timeouts;
+    }
+
+    Arguments parseArguments(int argc, char **argv) {
+        if (argc < 2) {
+            throw std::runtime_error{"missing image folder"};
+        }
+        Arguments arguments;
+        arguments.imageFolder = argv[1];
+        arguments.annotationsFile = arguments.imageFolder / "annotations.txt";
+        for (int i = 2; i < argc; ++i) {
+            const std::string argument = argv[i];
+            if (i + 1 >= argc) {
+                throw std::runtime_error{"missing value for " + argument};
+            }
+            const std::string value = argv[++i];
+            if (argument == "--annotations") {
+                arguments.annotationsFile = value;
+            } else if (argument == "--output") {
+                arguments.outputFile = value;
+            } else if (argument == "--threads") {
+                arguments.threadCount = std::max<size_t>(1, std::stoul(value));
+            } else if (argument == "--timeouts") {
+                arguments.timeouts = parseTimeouts(value);
+            } else if (argument == "--min-recall") {
+                arguments.minRecall = std::stod(value);
+            } else {
+                throw std::runtime_error{"unknown argument " + argument};
+            }
+        }
+        return arguments;
+    }
+
+    std::vector<sfdm::ReaderConfig> createCandidates(const std::vector<uint32_t> &timeouts) {
+        std::vector<sfdm::ReaderConfig> candidates;
+        candidates.push_back({sfdm::ReaderBackend::ZXing, 0, false});
+        for (const auto timeout: timeouts) {
+            candidates.push_back({sfdm::ReaderBackend::Libdmtx, timeout, false});
+            candidates.push_back({sfdm::ReaderBackend::Combined, timeout, true});
+            candidates.push_back({sfdm::ReaderBackend::Combined, timeout, false});
+        }
+        return candidates;
+    }
+
+    Measurement measure(const sfdm::ReaderConfig &config, sfdm::tools::LabeledImage &image) {
+        const auto reader = sfdm::createCodeReader(config);
+        auto options = reader->getDefaultOptions();
+        options.maximumNumberOfCodesToDetect = image.expectedTexts.size();
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto results = reader->decode(image.image.view(), options);
+        const auto end = std::chrono::steady_clock::now();
+
+        std::vector<std::string> foundTexts;
+        foundTexts.reserve(results.size());
+        for (const auto &result: results) {
+            foundTexts.emplace_back(sfdm::tools::normalizeText(result.text));
+        }
+        return {std::chrono::duration<double, std::milli>(end - start).count(),
+                sfdm::tools::countMatches(std::move(foundTexts), image.expectedTexts)};
+    }
+
+    // every (configuration, image) pair is an independent job, so the sweep can run in parallel over both. The
+    // images are loaded before, so with one thread nothing else runs during a timed decode.
+    std::vector<Measurement> runSweep(const std::vector<sfdm::ReaderConfig> &candidates,
+                                      std::vector<sfdm::tools::LabeledImage> &images, size_t threadCount) {
+        std::vector<Measurement> measurements(candidates.size() * images.size());
+        std::atomic<size_t> nextJob = 0;
+        std::atomic<size_t> doneJobs = 0;
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(threadCount);
+            for (size_t i = 0; i < threadCount; ++i) {
+                workers.emplace_back([&] {
+                    for (size_t job = nextJob++; job < measurements.size(); job = nextJob++) {
+                        measurements[job] = measure(candidates[job / images.size()], images[job % images.size()]);
+                        const auto done = ++doneJobs;
+                        if (done % images.size() == 0) {
+                            std::cerr << "\r" << done << "/" << measurements.size() << " decodes" << std::flush;
+                        }
+                    }
+                });
+            }
+        }
+        std::cerr << '\n';
+        return measurements;
+    }
+
+    std::vector<Evaluation> evaluate(const std::vector<sfdm::ReaderConfig> &candidates,
+                                     const std::vector<Measurement> &measurements, size_t imageCount,
+                                     size_t totalCodes) {
+        std::vector<Evaluation> evaluations;
+        evaluations.reserve(candidates.size());
+        for (size_t c = 0; c < candidates.size(); ++c) {
+            Evaluation evaluation{candidates[c]};
+            size_t found = 0;
+            for (size_t i = 0; i < imageCount; ++i) {
+                const auto &measurement = measurements[c * imageCount + i];
+                evaluation.meanMilliseconds += measurement.milliseconds;
+                evaluation.maxMilliseconds = std::max(evaluation.maxMilliseconds, measurement.milliseconds);
+                found += measurement.found;
+            }
+            evaluation.meanMilliseconds /= static_cast<double>(imageCount);
+            evaluation.recall = static_cast<double>(found) / static_cast<double>(totalCodes);
+            evaluations.emplace_back(evaluation);
+        }
+
+        // sorted by latency, a configuration is on the frontier if it has a better recall than every faster one
+        std::ranges::sort(evaluations, [](const Evaluation &lhs, const Evaluation &rhs) {
+            if (lhs.meanMilliseconds != rhs.meanMilliseconds) {
+                return lhs.meanMilliseconds < rhs.meanMilliseconds;
+            }
+            return lhs.recall > rhs.recall;
+        });
+        double bestRecall = -1.0;
+        for (auto &evaluation: evaluations) {
+            if (evaluation.recall > bestRecall) {
+                evaluation.paretoOptimal = true;
+                bestRecall = evaluation.recall;
+            }
+        }
+        return evaluations;
+    }
+
+    const Evaluation &recommend(const std::vector<Evaluation> &evaluations, double minRecall) {
+        const auto best = std::ranges::max_element(evaluations, {}, &Evaluation::recall);
+        const double requiredRecall = minRecall < 0.0 ? best->recall : minRecall;
+        const auto it = std::ranges::find_if(evaluations, [&](const Evaluation &evaluation) {
+            return evaluation.paretoOptimal && evaluation.recall >= requiredRecall;
+        });
+        return it != evaluations.end() ? *it : *best;
+    }
+
+    void printTable(const std::vector<Evaluation> &evaluations) {
+        std::cout << "| Pareto | Backend  | Timeout | Double check | Mean      | Max       | Recall  |\n";
+        std::cout << "|--------|----------|---------|--------------|-----------|-----------|---------|\n";
+        for (const auto &evaluation: evaluations) {
+            std::cout << std::fixed << std::setprecision(2) << "| " << std::setw(6)
+                      << (evaluation.paretoOptimal ? "*" : "") << " | " << std::setw(8)
+                      << sfdm::toString(evaluation.config.backend) << " | " << std::setw(5)
+                      << evaluation.config.timeoutMSec << "ms | " << std::setw(12)
+                      << (evaluation.config.backend == sfdm::ReaderBackend::Combined
+                                  ? (evaluation.config.doubleCheckZXing ? "on" : "off")
+                                  : "-")
+                      << " | " << std::setw(7) << evaluation.meanMilliseconds << "ms | " << std::setw(7)
+                      << evaluation.maxMilliseconds << "ms | " << std::setw(6) << evaluation.recall * 100.0
+                      << "% |\n";
+        }
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    try {
+        const auto arguments = parseArguments(argc, argv);
+        const auto annotations = sfdm::tools::readAnnotations(arguments.annotationsFile);
+        if (annotations.empty()) {
+            throw std::runtime_error{"no annotations found in " + arguments.annotationsFile.string()};
+        }
+        auto images = sfdm::tools::loadLabeledImages(arguments.imageFolder, annotations);
+        if (images.empty()) {
+            throw std::runtime_error{"no annotated images found in " + arguments.imageFolder.string()};
+        }
+        size_t totalCodes = 0;
+        for (const auto &image: images) {
+            totalCodes += image.expectedTexts.size();
+        }
+
+        const auto candidates = createCandidates(arguments.timeouts);
+        std::cerr << "evaluating " << candidates.size() << " configurations on " << images.size() << " images ("
+                  << totalCodes << " codes) with " << arguments.threadCount << " threads\n";
+        if (arguments.threadCount > 1) {
+            std::cerr << "warning: decodes run concurrently, latencies and recall with timeouts are biased\n";
+        }
+
+        const auto measurements = runSweep(candidates, images, arguments.threadCount);
+        const auto evaluations = evaluate(candidates, measurements, images.size(), totalCodes);
+        printTable(evaluations);
+
+        const auto &recommended = recommend(evaluations, arguments.minRecall);
+        sfdm::saveReaderConfig(arguments.outputFile, recommended.config);
+        std::cout << "\nrecommended configuration written to " << arguments.outputFile.string() << ":\n";
+        sfdm::writeReaderConfig(std::cout, recommended.config);
+    } catch (const std::exception &e) {
+        std::cerr << "error: " << e.what() << '\n';
+        printUsage();
+        return 1;
+    }
+    return 0;
+}